@@ -0,0 +1,418 @@
+#include "Benchmarks.h"
+#include "Camera.h"
+#include "FrameUniforms.h"
+#include "GLStateCache.h"
+#include "Model.h"
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "ShaderCache.h"
+#include "ShaderLibrary.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	struct ProgramDesc
+	{
+		const char* vertexPath;
+
+		const char* fragmentPath;
+
+		const char* geometryPath;
+	};
+
+	/* programs compiled before the first frame of the PBR/IBL, deferred and SSAO demos */
+	const ProgramDesc startupPrograms[] = {
+		{"Shaders/2.2.2.pbr.vs", "Shaders/2.2.2.pbr.fs", nullptr},
+		{"Shaders/2.2.2.cubemap.vs", "Shaders/2.2.2.equirectangular_to_cubemap.fs", nullptr},
+		{"Shaders/2.2.2.cubemap.vs", "Shaders/2.2.2.irradiance_convolution.fs", nullptr},
+		{"Shaders/2.2.2.cubemap.vs", "Shaders/2.2.2.prefilter.fs", nullptr},
+		{"Shaders/2.2.2.brdf.vs", "Shaders/2.2.2.brdf.fs", nullptr},
+		{"Shaders/2.2.2.background.vs", "Shaders/2.2.2.background.fs", nullptr},
+		{"Shaders/8.2.g_buffer.vs", "Shaders/8.2.g_buffer.fs", nullptr},
+		{"Shaders/8.2.deferred_shading.vs", "Shaders/8.2.deferred_shading.fs", nullptr},
+		{"Shaders/8.2.deferred_light_box.vs", "Shaders/8.2.deferred_light_box.fs", nullptr},
+		{"Shaders/9.ssao_geometry.vs", "Shaders/9.ssao_geometry.fs", nullptr},
+		{"Shaders/9.ssao.vs", "Shaders/9.ssao.fs", nullptr},
+		{"Shaders/9.ssao.vs", "Shaders/9.ssao_blur.fs", nullptr},
+		{"Shaders/9.ssao.vs", "Shaders/9.ssao_lighting.fs", nullptr},
+		{"Shaders/3.2.1.point_shadows_depth.vs", "Shaders/3.2.1.point_shadows_depth.fs",
+			"Shaders/3.2.1.point_shadows_depth.gs"},
+	};
+
+	/* builds every startup program through a ShaderLibrary (all compiles in flight at once) and returns the elapsed wall time in milliseconds */
+	double buildStartupPrograms()
+	{
+		/* the fallback program is compiled here, outside the timed part */
+		ShaderLibrary library(ThreadPool::shared());
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (const auto& desc : startupPrograms)
+		{
+			library.add(desc.fragmentPath, desc.vertexPath, desc.fragmentPath,
+			            desc.geometryPath != nullptr ? desc.geometryPath : std::string());
+		}
+
+		library.finish();
+
+		/* make sure deferred driver work is included */
+		glFinish();
+
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		for (const auto& desc : startupPrograms)
+		{
+			if (!library.isReady(desc.fragmentPath))
+			{
+				std::cout << "ERROR::BENCHMARK::SHADER_CACHE: " << desc.fragmentPath << " failed to build" << std::endl;
+			}
+		}
+
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	/* offscreen target of the draw benchmarks, the size of the demo window */
+	const auto BENCHMARK_WIDTH = 800;
+
+	const auto BENCHMARK_HEIGHT = 600;
+
+	/* rocks in the asteroid field of the instancing demo, and frames timed per pass */
+	const auto ASTEROID_COUNT = 5000;
+
+	const auto LOD_FRAMES = 20;
+
+	/* the instancing demo's camera position, the field lies around the origin */
+	const glm::vec3 ASTEROID_CAMERA(0.f, 0.f, 155.f);
+
+	/* the rock transforms of the instancing demo's asteroid field, the same on every call */
+	std::vector<glm::mat4> makeAsteroidField()
+	{
+		std::vector<glm::mat4> transforms;
+
+		std::srand(1);
+
+		const auto radius = 150.f;
+
+		const auto offset = 25.f;
+
+		for (auto i = 0; i < ASTEROID_COUNT; ++i)
+		{
+			const auto angle = static_cast<float>(i) / ASTEROID_COUNT * 360.f;
+
+			const auto displacement = [offset]() { return std::rand() % static_cast<int>(2 * offset * 100) / 100.f - offset; };
+
+			const auto x = std::sin(glm::radians(angle)) * radius + displacement();
+
+			const auto y = displacement() * 0.4f;
+
+			const auto z = std::cos(glm::radians(angle)) * radius + displacement();
+
+			auto transform = glm::translate(glm::mat4(1.f), glm::vec3(x, y, z));
+
+			transform = glm::scale(transform, glm::vec3(std::rand() % 20 / 100.f + 0.05f));
+
+			transform = glm::rotate(transform, static_cast<float>(std::rand() % 360), glm::vec3(0.4f, 0.6f, 0.8f));
+
+			transforms.push_back(transform);
+		}
+
+		return transforms;
+	}
+
+	/* uploads the camera's perspective for the benchmark target */
+	void setAsteroidCamera(FrameUniforms& frameUniforms, const Camera& camera)
+	{
+		frameUniforms.setCamera(glm::perspective(glm::radians(camera.Zoom),
+		                                         static_cast<float>(BENCHMARK_WIDTH) / BENCHMARK_HEIGHT, 0.1f, 1000.f),
+		                        camera.GetViewMatrix(), camera.Position);
+
+		frameUniforms.upload();
+	}
+
+	/* colour and depth target the size of the demo window, bound with depth testing on while it exists */
+	class OffscreenTarget
+	{
+	public:
+		OffscreenTarget()
+		{
+			glGenFramebuffers(1, &framebuffer);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+			glGenRenderbuffers(2, renderbuffers);
+
+			glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+
+			glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+			glViewport(0, 0, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+
+			GLStateCache::setEnabled(GL_DEPTH_TEST, true);
+		}
+
+		~OffscreenTarget()
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glDeleteRenderbuffers(2, renderbuffers);
+
+			glDeleteFramebuffers(1, &framebuffer);
+		}
+
+		OffscreenTarget(const OffscreenTarget&) = delete;
+
+		OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+	private:
+		unsigned int framebuffer;
+
+		unsigned int renderbuffers[2];
+	};
+
+	/* draws the field frames times, with or without levels of detail, returns the counts of the last frame */
+	MeshLodStats drawAsteroids(const Model& rock, const Shader& shader, const std::vector<glm::mat4>& transforms,
+	                           const Camera& camera, const bool useLods, const int frames)
+	{
+		MeshLodStats frame;
+
+		for (auto i = 0; i < frames; ++i)
+		{
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			frame = MeshLodStats();
+
+			for (const auto& transform : transforms)
+			{
+				shader.setMat4("model", transform);
+
+				if (useLods)
+				{
+					frame.add(rock.DrawLod(shader, transform, camera, static_cast<float>(BENCHMARK_HEIGHT)));
+				}
+				else
+				{
+					rock.Draw(shader);
+
+					for (const auto& mesh : rock.meshes)
+					{
+						frame.triangles += mesh.getIndexCount() / 3;
+					}
+				}
+			}
+		}
+
+		return frame;
+	}
+
+	/* times LOD_FRAMES frames of the field and prints the frame time and throughput */
+	void timeAsteroids(const char* name, const Model& rock, const Shader& shader, const std::vector<glm::mat4>& transforms,
+	                   const Camera& camera, const bool useLods)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		const auto frame = drawAsteroids(rock, shader, transforms, camera, useLods, LOD_FRAMES);
+
+		glFinish();
+
+		const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start)
+			.count() / LOD_FRAMES;
+
+		std::cout << name << ": " << milliseconds << " ms per frame, " << frame.triangles << " triangles per frame, " <<
+			frame.triangles / milliseconds / 1000.0 << " M triangles/s" << std::endl;
+	}
+
+	void printPass(const char* name, const double milliseconds)
+	{
+		const auto& stats = ShaderCache::getStats();
+
+		std::cout << name << ": " << milliseconds << " ms (hits " << stats.hits << ", misses " << stats.misses <<
+			", rejected " << stats.rejected << ", stored " << stats.stored << ")" << std::endl;
+	}
+}
+
+void benchmarkShaderCache()
+{
+	const auto count = sizeof(startupPrograms) / sizeof(startupPrograms[0]);
+
+	std::cout << "shader cache benchmark, " << count << " programs, binary cache " <<
+		(ShaderCache::isSupported() ? "supported" : "NOT supported") << std::endl;
+
+	const auto wasEnabled = ShaderCache::enabled;
+
+	/* cold: compile everything from source */
+	ShaderCache::enabled = false;
+
+	ShaderCache::resetStats();
+
+	printPass("cold  ", buildStartupPrograms());
+
+	/* first launch: compile from source and write the binaries (entries from an earlier run are hits here) */
+	ShaderCache::enabled = true;
+
+	ShaderCache::resetStats();
+
+	printPass("first ", buildStartupPrograms());
+
+	/* warm: everything comes from the cache */
+	ShaderCache::resetStats();
+
+	printPass("warm  ", buildStartupPrograms());
+
+	ShaderCache::enabled = wasEnabled;
+}
+
+void benchmarkLod()
+{
+	const auto path = "Objects/rock/rock.obj";
+
+	ModelLoadOptions options;
+
+	options.optimizeMeshes = true;
+
+	options.generateLods = true;
+
+	options.reportMeshStats = true;
+
+	const Model rock(path, false, options);
+
+	if (rock.meshes.empty())
+	{
+		std::cout << "ERROR::BENCHMARK::LOD: could not load " << path << std::endl;
+
+		return;
+	}
+
+	/* the timed frames have to sample the real texture, not the placeholder */
+	TextureLoader::finish();
+
+	const Camera camera(ASTEROID_CAMERA);
+
+	const auto transforms = makeAsteroidField();
+
+	const OffscreenTarget target;
+
+	const Shader shader("Shaders/10.3.planet.vs", "Shaders/10.3.planet.fs");
+
+	shader.use();
+
+	/* the camera reaches the program through the shared FrameData block */
+	FrameUniforms frameUniforms;
+
+	setAsteroidCamera(frameUniforms, camera);
+
+	std::cout << "lod benchmark, " << ASTEROID_COUNT << " rocks, " << LOD_FRAMES << " frames per pass" << std::endl;
+
+	/* once untimed so both passes find the textures and binding tables resolved */
+	drawAsteroids(rock, shader, transforms, camera, false, 1);
+
+	timeAsteroids("full  ", rock, shader, transforms, camera, false);
+
+	timeAsteroids("lod   ", rock, shader, transforms, camera, true);
+}
+
+void benchmarkRenderQueue()
+{
+	const auto path = "Objects/rock/rock.obj";
+
+	const Model rock(path);
+
+	if (rock.meshes.empty())
+	{
+		std::cout << "ERROR::BENCHMARK::RENDER_QUEUE: could not load " << path << std::endl;
+
+		return;
+	}
+
+	TextureLoader::finish();
+
+	const Camera camera(ASTEROID_CAMERA);
+
+	const auto transforms = makeAsteroidField();
+
+	const OffscreenTarget target;
+
+	const Shader shader("Shaders/10.3.planet.vs", "Shaders/10.3.planet.fs");
+
+	FrameUniforms frameUniforms;
+
+	setAsteroidCamera(frameUniforms, camera);
+
+	RenderQueue queue;
+
+	queue.setViewPosition(camera.Position);
+
+	std::cout << "render queue benchmark, " << ASTEROID_COUNT << " rocks, " << LOD_FRAMES << " frames per pass" <<
+		std::endl;
+
+	shader.use();
+
+	drawAsteroids(rock, shader, transforms, camera, false, 1);
+
+	timeAsteroids("direct", rock, shader, transforms, camera, false);
+
+	/* the same draws submitted in field order, sorted front to back and grouped by state */
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (auto i = 0; i < LOD_FRAMES; ++i)
+	{
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		for (const auto& transform : transforms)
+		{
+			queue.submit(Render_Pass::OPAQUE_PASS, shader, rock, transform);
+		}
+
+		queue.flush();
+	}
+
+	glFinish();
+
+	const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start)
+		.count() / LOD_FRAMES;
+
+	const auto& stats = queue.getStats();
+
+	std::cout << "queue : " << milliseconds << " ms per frame, " << stats.draws << " draws, " << stats.programChanges <<
+		" program changes, " << stats.materialChanges << " material changes" << std::endl;
+}
+
+bool runBenchmark(const char* name)
+{
+	if (std::strcmp(name, "shader_cache") == 0)
+	{
+		benchmarkShaderCache();
+
+		return true;
+	}
+
+	if (std::strcmp(name, "lod") == 0)
+	{
+		benchmarkLod();
+
+		return true;
+	}
+
+	if (std::strcmp(name, "render_queue") == 0)
+	{
+		benchmarkRenderQueue();
+
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+/*
+ * Benchmarks run from the command line (LearnOpenGL --benchmark <name>) with a current GL context.
+ * Results are printed to stdout.
+ */
+
+/*
+ * Builds the PBR/IBL, deferred and SSAO program chains through a ShaderLibrary three times: without the program
+ * binary cache (cold launch), with an empty cache (first launch, includes writing the binaries) and with a filled
+ * cache (warm launch).
+ * Note that most drivers keep their own shader cache as well, clear it to measure a true cold start.
+ */
+void benchmarkShaderCache();
+
+/*
+ * Draws the asteroid field of the instancing demo (Objects/rock/rock.obj) one rock at a time, with the full meshes
+ * and with levels of detail picked for a 1 pixel error, and prints frame time and triangle throughput of both.
+ */
+void benchmarkLod();
+
+/*
+ * Draws the same asteroid field through the RenderQueue (submitted in field order, sorted front to back and grouped
+ * by state) and directly in field order, and prints frame times and the queue's draw and state change counts.
+ */
+void benchmarkRenderQueue();
+
+/* runs the named benchmark, returns false if there is no benchmark with that name */
+bool runBenchmark(const char* name);
+
+#endif
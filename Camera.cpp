@@ -1,4 +1,5 @@
 #include "Camera.h"
+#include <cmath>
 
 Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch): Front(glm::vec3(0.f, 0.f, -1.f)),
                                                                           MovementSpeed(SPEED),
@@ -34,6 +35,12 @@ glm::mat4 Camera::GetViewMatrix() const
 	return lookAt(Position, Position + Front, Up);
 }
 
+float Camera::GetProjectedSize(const float worldSize, const float distance, const float viewportHeight) const
+{
+	/* the viewport spans 2 * tan(fov / 2) * distance world units vertically, Zoom is the vertical field of view */
+	return worldSize * viewportHeight / (2.f * std::tan(glm::radians(Zoom) * 0.5f) * distance);
+}
+
 void Camera::ProcessKeyboard(const Camera_Movement direction, const float deltaTime)
 {
 	const auto velocity = MovementSpeed * deltaTime;
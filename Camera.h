@@ -63,6 +63,9 @@ public:
 	/* Returns the view matrix calculated using Euler Angles and the LookAt Matrix */
 	glm::mat4 GetViewMatrix() const;
 
+	/* Returns the height in pixels of something worldSize high at distance from the camera, on a viewport viewportHeight pixels high */
+	float GetProjectedSize(float worldSize, float distance, float viewportHeight) const;
+
 	/* Processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems) */
 	void ProcessKeyboard(Camera_Movement direction, float deltaTime);
 
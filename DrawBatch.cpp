@@ -0,0 +1,231 @@
+#include "DrawBatch.h"
+#include "GeometryArena.h"
+#include "GLExtensions.h"
+#include "GLStateCache.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include <algorithm>
+
+namespace
+{
+	/* orders meshes by texture set, then index type, so equal materials end up next to each other */
+	int compareMaterial(const Mesh& a, const Mesh& b)
+	{
+		if (a.textures.size() != b.textures.size())
+		{
+			return a.textures.size() < b.textures.size() ? -1 : 1;
+		}
+
+		for (auto i = 0u; i < a.textures.size(); ++i)
+		{
+			if (a.textures[i].id != b.textures[i].id)
+			{
+				return a.textures[i].id < b.textures[i].id ? -1 : 1;
+			}
+
+			if (a.textures[i].type != b.textures[i].type)
+			{
+				return a.textures[i].type < b.textures[i].type ? -1 : 1;
+			}
+		}
+
+		if (a.getIndexType() != b.getIndexType())
+		{
+			return a.getIndexType() < b.getIndexType() ? -1 : 1;
+		}
+
+		return 0;
+	}
+}
+
+DrawBatch::~DrawBatch()
+{
+	if (drawDataTexture != 0)
+	{
+		GLStateCache::forgetTexture(drawDataTexture);
+
+		glDeleteTextures(1, &drawDataTexture);
+	}
+
+	for (auto buffer : {commandBuffer, drawDataBuffer})
+	{
+		if (buffer != 0)
+		{
+			GLStateCache::forgetBuffer(buffer);
+
+			glDeleteBuffers(1, &buffer);
+		}
+	}
+}
+
+bool DrawBatch::isBatchedShader(const Shader& shader)
+{
+	return shader.getUniform("meshDrawData").isValid();
+}
+
+void DrawBatch::draw(const Shader& shader, const std::vector<Mesh>& meshes)
+{
+	if (!built || builtMeshCount != meshes.size() || builtGeneration != GeometryArena::getGeneration())
+	{
+		build(meshes);
+	}
+
+	if (commands.empty())
+	{
+		return;
+	}
+
+	GLStateCache::bindVertexArray(GeometryArena::getVertexArray());
+
+	GLStateCache::bindTexture(DRAW_DATA_UNIT, GL_TEXTURE_BUFFER, drawDataTexture);
+
+	shader.setInt("meshDrawData", DRAW_DATA_UNIT);
+
+	if (GLEXT_ARB_multi_draw_indirect)
+	{
+		GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	}
+
+	for (const auto& bucket : buckets)
+	{
+		meshes[bucket.mesh].bindTextures(shader);
+
+		shader.flush();
+
+		if (GLEXT_ARB_multi_draw_indirect)
+		{
+			glMultiDrawElementsIndirect(GL_TRIANGLES, bucket.indexType,
+			                            reinterpret_cast<void*>(bucket.firstCommand * sizeof(DrawElementsIndirectCommand)),
+			                            static_cast<GLsizei>(bucket.commandCount), 0);
+
+			continue;
+		}
+
+		const auto indexSize = bucket.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		for (auto i = bucket.firstCommand; i < bucket.firstCommand + bucket.commandCount; ++i)
+		{
+			const auto& command = commands[i];
+
+			glVertexAttribI1ui(GeometryArena::DRAW_INDEX_ATTRIBUTE, command.baseInstance);
+
+			glDrawElementsBaseVertex(GL_TRIANGLES, command.count, bucket.indexType,
+			                         reinterpret_cast<void*>(command.firstIndex * indexSize), command.baseVertex);
+		}
+	}
+}
+
+size_t DrawBatch::getBucketCount() const
+{
+	return buckets.size();
+}
+
+size_t DrawBatch::getDrawCount() const
+{
+	return commands.size();
+}
+
+void DrawBatch::build(const std::vector<Mesh>& meshes)
+{
+	std::vector<size_t> order;
+
+	for (auto i = 0u; i < meshes.size(); ++i)
+	{
+		if (meshes[i].getGeometry() != GeometryArena::INVALID)
+		{
+			order.push_back(i);
+		}
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&meshes](const size_t a, const size_t b)
+	{
+		return compareMaterial(meshes[a], meshes[b]) < 0;
+	});
+
+	buckets.clear();
+
+	commands.clear();
+
+	std::vector<float> drawData;
+
+	drawData.reserve(order.size() * 8);
+
+	for (const auto index : order)
+	{
+		const auto& mesh = meshes[index];
+
+		if (buckets.empty() || compareMaterial(meshes[buckets.back().mesh], mesh) != 0)
+		{
+			buckets.push_back(Bucket{index, mesh.getIndexType(), commands.size(), 0});
+		}
+
+		const auto& range = GeometryArena::getRange(mesh.getGeometry());
+
+		const auto indexSize = mesh.getIndexType() == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		DrawElementsIndirectCommand command;
+
+		command.count = static_cast<uint32_t>(mesh.getIndexCount());
+
+		command.instanceCount = 1;
+
+		command.firstIndex = static_cast<uint32_t>(range.indexOffset / indexSize);
+
+		command.baseVertex = static_cast<int32_t>(range.baseVertex);
+
+		command.baseInstance = static_cast<uint32_t>(commands.size());
+
+		commands.push_back(command);
+
+		++buckets.back().commandCount;
+
+		const auto& scale = mesh.getPositionScale();
+
+		const auto& offset = mesh.getPositionOffset();
+
+		drawData.insert(drawData.end(), {scale.x, scale.y, scale.z, static_cast<float>(buckets.size() - 1)});
+
+		drawData.insert(drawData.end(), {offset.x, offset.y, offset.z, 0.f});
+	}
+
+	built = true;
+
+	builtMeshCount = meshes.size();
+
+	builtGeneration = GeometryArena::getGeneration();
+
+	if (commands.empty())
+	{
+		return;
+	}
+
+	if (drawDataBuffer == 0)
+	{
+		glGenBuffers(1, &drawDataBuffer);
+
+		glGenTextures(1, &drawDataTexture);
+	}
+
+	GLStateCache::bindBuffer(GL_TEXTURE_BUFFER, drawDataBuffer);
+
+	glBufferData(GL_TEXTURE_BUFFER, drawData.size() * sizeof(float), drawData.data(), GL_STATIC_DRAW);
+
+	GLStateCache::bindTexture(DRAW_DATA_UNIT, GL_TEXTURE_BUFFER, drawDataTexture);
+
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, drawDataBuffer);
+
+	if (GLEXT_ARB_multi_draw_indirect)
+	{
+		if (commandBuffer == 0)
+		{
+			glGenBuffers(1, &commandBuffer);
+		}
+
+		GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(),
+		             GL_STATIC_DRAW);
+
+		GeometryArena::reserveDrawIndices(commands.size());
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef DRAW_BATCH_H
+#define DRAW_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Mesh;
+class Shader;
+
+/*
+ * Batched submission of a list of meshes: meshes with the same textures and index type form a bucket, which
+ * binds its textures once and draws all its meshes with a single glMultiDrawElementsIndirect.
+ * What differs per mesh (its position bounds) lives in a texture buffer indexed by the draw index, which
+ * every indirect command passes as its base instance (see GeometryArena::reserveDrawIndices).
+ * Shaders opt in with MESH_DRAW_BATCHED (Shaders/include/mesh_vertex.glsl).
+ * Without GL_ARB_multi_draw_indirect the buckets are drawn one mesh at a time, with the draw index set as a
+ * constant vertex attribute, which still only binds textures once per bucket.
+ */
+class DrawBatch
+{
+public:
+	/* texture unit of the per draw data, far above the material textures */
+	static const unsigned int DRAW_DATA_UNIT = 31;
+
+	DrawBatch() = default;
+
+	~DrawBatch();
+
+	DrawBatch(const DrawBatch&) = delete;
+
+	DrawBatch& operator=(const DrawBatch&) = delete;
+
+	/* true if the shader reads the per draw data, i.e. it was compiled with MESH_DRAW_BATCHED */
+	static bool isBatchedShader(const Shader& shader);
+
+	/* draws the meshes, the buckets are rebuilt first if the meshes or their arena ranges changed */
+	void draw(const Shader& shader, const std::vector<Mesh>& meshes);
+
+	size_t getBucketCount() const;
+
+	size_t getDrawCount() const;
+
+private:
+	/* layout defined by GL for indirect indexed draws */
+	struct DrawElementsIndirectCommand
+	{
+		uint32_t count;
+
+		uint32_t instanceCount;
+
+		uint32_t firstIndex;
+
+		int32_t baseVertex;
+
+		uint32_t baseInstance;
+	};
+
+	struct Bucket
+	{
+		/* mesh whose textures the bucket binds */
+		size_t mesh;
+
+		unsigned int indexType;
+
+		size_t firstCommand;
+
+		size_t commandCount;
+	};
+
+	std::vector<Bucket> buckets;
+
+	std::vector<DrawElementsIndirectCommand> commands;
+
+	unsigned int commandBuffer = 0;
+
+	/* two RGBA32F texels per draw: position scale (w is the bucket) and position offset */
+	unsigned int drawDataBuffer = 0;
+
+	unsigned int drawDataTexture = 0;
+
+	/* what the buckets were built from */
+	size_t builtMeshCount = 0;
+
+	unsigned int builtGeneration = 0;
+
+	bool built = false;
+
+	void build(const std::vector<Mesh>& meshes);
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifndef __linux__
+	/* how often modification times are compared when the platform can't notify us */
+	const auto SCAN_INTERVAL = std::chrono::milliseconds(250);
+#endif
+
+	std::string directoryOf(const std::string& path)
+	{
+		const auto slash = path.find_last_of("/\\");
+
+		return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+	}
+}
+
+FileWatcher::FileWatcher()
+{
+#ifdef __linux__
+	inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (inotify < 0)
+	{
+		std::cout << "ERROR::FILE_WATCHER::INOTIFY_UNAVAILABLE" << std::endl;
+	}
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if (inotify >= 0)
+	{
+		close(inotify);
+	}
+#endif
+}
+
+void FileWatcher::watch(const std::string& path)
+{
+	if (files.find(path) != files.end())
+	{
+		return;
+	}
+
+	files[path] = modificationTime(path);
+
+#ifdef __linux__
+	if (inotify < 0)
+	{
+		return;
+	}
+
+	const auto directory = directoryOf(path);
+
+	const auto descriptor = inotify_add_watch(inotify, directory.empty() ? "." : directory.c_str(),
+	                                          IN_CLOSE_WRITE | IN_MOVED_TO);
+
+	if (descriptor < 0)
+	{
+		std::cout << "ERROR::FILE_WATCHER::WATCH_FAILED " << path << std::endl;
+
+		return;
+	}
+
+	/* the same directory returns the same descriptor, however it was spelled */
+	auto& prefixes = directories[descriptor];
+
+	if (std::find(prefixes.begin(), prefixes.end(), directory) == prefixes.end())
+	{
+		prefixes.push_back(directory);
+	}
+#endif
+}
+
+std::vector<std::string> FileWatcher::poll()
+{
+	std::vector<std::string> changed;
+
+#ifdef __linux__
+	alignas(inotify_event) char buffer[4096];
+
+	ssize_t length;
+
+	while (inotify >= 0 && (length = read(inotify, buffer, sizeof(buffer))) > 0)
+	{
+		for (auto offset = 0; offset < length;)
+		{
+			const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+
+			offset += static_cast<int>(sizeof(inotify_event) + event->len);
+
+			const auto prefixes = directories.find(event->wd);
+
+			if (event->len == 0 || prefixes == directories.end())
+			{
+				continue;
+			}
+
+			for (const auto& directory : prefixes->second)
+			{
+				const auto path = directory + event->name;
+
+				if (files.find(path) != files.end() &&
+					std::find(changed.begin(), changed.end(), path) == changed.end())
+				{
+					changed.push_back(path);
+				}
+			}
+		}
+	}
+#else
+	const auto now = std::chrono::steady_clock::now();
+
+	if (now - lastScan < SCAN_INTERVAL)
+	{
+		return changed;
+	}
+
+	lastScan = now;
+
+	for (auto& file : files)
+	{
+		const auto time = modificationTime(file.first);
+
+		if (time != file.second)
+		{
+			file.second = time;
+
+			changed.push_back(file.first);
+		}
+	}
+#endif
+
+	return changed;
+}
+
+time_t FileWatcher::modificationTime(const std::string& path)
+{
+	struct stat status;
+
+	return stat(path.c_str(), &status) == 0 ? status.st_mtime : 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Reports files that were written since the last poll, without ever blocking.
+ * Uses inotify on the watched files' directories on Linux (editors often save by renaming a temporary file,
+ * which a watch on the file itself would lose) and compares modification times a few times a second elsewhere.
+ */
+class FileWatcher
+{
+public:
+	FileWatcher();
+
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	/* starts watching a file, watching it again is a no-op */
+	void watch(const std::string& path);
+
+	/* returns the watched paths (as passed to watch) that changed since the last call, each one once */
+	std::vector<std::string> poll();
+
+private:
+	/* watched path -> last seen modification time */
+	std::unordered_map<std::string, time_t> files;
+
+#ifdef __linux__
+	int inotify;
+
+	/* watch descriptor -> directory prefixes of the watched files in it (one directory may be spelled several ways) */
+	std::unordered_map<int, std::vector<std::string>> directories;
+#else
+	std::chrono::steady_clock::time_point lastScan;
+#endif
+
+	static time_t modificationTime(const std::string& path);
+};
+
+#endif
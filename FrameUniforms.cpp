@@ -0,0 +1,40 @@
+#include "FrameUniforms.h"
+#include <cstddef>
+
+FrameUniforms::FrameUniforms() : frame(), lights(), frameBuffer(sizeof(FrameBlock), FRAME_DATA_BINDING),
+                                 lightBuffer(sizeof(LightBlock), LIGHT_DATA_BINDING)
+{
+}
+
+void FrameUniforms::setCamera(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& viewPos)
+{
+	frame.projection = projection;
+
+	frame.view = view;
+
+	frame.viewPos = viewPos;
+}
+
+bool FrameUniforms::addLight(const LightDesc& light)
+{
+	if (lights.lightCount >= MAX_LIGHTS)
+	{
+		return false;
+	}
+
+	lights.lights[lights.lightCount++] = light;
+
+	return true;
+}
+
+void FrameUniforms::clearLights()
+{
+	lights.lightCount = 0;
+}
+
+void FrameUniforms::upload()
+{
+	frameBuffer.update(&frame, sizeof(frame));
+
+	lightBuffer.update(&lights, offsetof(LightBlock, lights) + sizeof(LightDesc) * lights.lightCount);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glm/glm.hpp>
+#include "UniformBuffer.h"
+
+/* must match MAX_LIGHTS in Shaders/include/light_uniforms.glsl */
+const auto MAX_LIGHTS = 256;
+
+/* std140 mirror of the FrameData block (Shaders/include/frame_uniforms.glsl) */
+struct FrameBlock
+{
+	glm::mat4 projection;
+
+	glm::mat4 view;
+
+	glm::vec3 viewPos;
+
+	float time;
+};
+
+/* std140 mirror of the Light struct (Shaders/include/light_uniforms.glsl), array stride is 48 bytes */
+struct LightDesc
+{
+	glm::vec3 Position;
+
+	float Linear;
+
+	glm::vec3 Color;
+
+	float Quadratic;
+
+	float Radius;
+
+	float padding[3];
+};
+
+/* std140 mirror of the LightData block, the array starts at the next 16 byte boundary after lightCount */
+struct LightBlock
+{
+	int lightCount;
+
+	int padding[3];
+
+	LightDesc lights[MAX_LIGHTS];
+};
+
+static_assert(sizeof(FrameBlock) == 144, "FrameBlock doesn't match the std140 layout of FrameData");
+
+static_assert(sizeof(LightDesc) == 48, "LightDesc doesn't match the std140 layout of Light");
+
+static_assert(sizeof(LightBlock) == 16 + 48 * MAX_LIGHTS, "LightBlock doesn't match the std140 layout of LightData");
+
+/*
+ * Per-frame data shared by every program through uniform buffers.
+ * Fill the blocks, then call upload() once per frame before drawing, programs never see per-program uniform calls for it.
+ */
+class FrameUniforms
+{
+public:
+	FrameBlock frame;
+
+	LightBlock lights;
+
+	FrameUniforms();
+
+	/* convenience for the camera part of the frame block */
+	void setCamera(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& viewPos);
+
+	/* appends a light, returns false once MAX_LIGHTS is reached */
+	bool addLight(const LightDesc& light);
+
+	void clearLights();
+
+	/* uploads both blocks, only the used part of the light array is transferred */
+	void upload();
+
+private:
+	UniformBuffer frameBuffer;
+
+	UniformBuffer lightBuffer;
+};
+
+#endif
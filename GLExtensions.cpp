@@ -0,0 +1,94 @@
+#include "GLExtensions.h"
+#include <cstring>
+
+int GLEXT_ARB_get_program_binary = 0;
+
+PFNGLEXTGETPROGRAMBINARYPROC glext_glGetProgramBinary = nullptr;
+
+PFNGLEXTPROGRAMBINARYPROC glext_glProgramBinary = nullptr;
+
+PFNGLEXTPROGRAMPARAMETERIPROC glext_glProgramParameteri = nullptr;
+
+int GLEXT_KHR_parallel_shader_compile = 0;
+
+PFNGLEXTMAXSHADERCOMPILERTHREADSPROC glext_glMaxShaderCompilerThreads = nullptr;
+
+int GLEXT_ARB_multi_draw_indirect = 0;
+
+PFNGLEXTMULTIDRAWELEMENTSINDIRECTPROC glext_glMultiDrawElementsIndirect = nullptr;
+
+int GLEXT_ARB_buffer_storage = 0;
+
+PFNGLEXTBUFFERSTORAGEPROC glext_glBufferStorage = nullptr;
+
+bool hasGLExtension(const char* name)
+{
+	GLint count = 0;
+
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+	for (auto i = 0; i < count; ++i)
+	{
+		const auto extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+
+		if (extension != nullptr && std::strcmp(extension, name) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool hasGLVersion(const int major, const int minor)
+{
+	return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+void loadGLExtensions(const GLADloadproc load)
+{
+	/* program binaries */
+	if (hasGLVersion(4, 1) || hasGLExtension("GL_ARB_get_program_binary"))
+	{
+		glext_glGetProgramBinary = reinterpret_cast<PFNGLEXTGETPROGRAMBINARYPROC>(load("glGetProgramBinary"));
+
+		glext_glProgramBinary = reinterpret_cast<PFNGLEXTPROGRAMBINARYPROC>(load("glProgramBinary"));
+
+		glext_glProgramParameteri = reinterpret_cast<PFNGLEXTPROGRAMPARAMETERIPROC>(load("glProgramParameteri"));
+
+		GLEXT_ARB_get_program_binary = glext_glGetProgramBinary != nullptr && glext_glProgramBinary != nullptr &&
+			glext_glProgramParameteri != nullptr;
+	}
+
+	/* non-blocking compile/link status queries, the KHR and ARB variants share the enums */
+	if (hasGLExtension("GL_KHR_parallel_shader_compile"))
+	{
+		glext_glMaxShaderCompilerThreads = reinterpret_cast<PFNGLEXTMAXSHADERCOMPILERTHREADSPROC>(
+			load("glMaxShaderCompilerThreadsKHR"));
+	}
+	else if (hasGLExtension("GL_ARB_parallel_shader_compile"))
+	{
+		glext_glMaxShaderCompilerThreads = reinterpret_cast<PFNGLEXTMAXSHADERCOMPILERTHREADSPROC>(
+			load("glMaxShaderCompilerThreadsARB"));
+	}
+
+	GLEXT_KHR_parallel_shader_compile = glext_glMaxShaderCompilerThreads != nullptr;
+
+	/* indirect multi draws with a usable base instance */
+	if (hasGLVersion(4, 3) ||
+		(hasGLExtension("GL_ARB_multi_draw_indirect") && hasGLExtension("GL_ARB_base_instance")))
+	{
+		glext_glMultiDrawElementsIndirect = reinterpret_cast<PFNGLEXTMULTIDRAWELEMENTSINDIRECTPROC>(
+			load("glMultiDrawElementsIndirect"));
+	}
+
+	GLEXT_ARB_multi_draw_indirect = glext_glMultiDrawElementsIndirect != nullptr;
+
+	/* persistently mapped buffers */
+	if (hasGLVersion(4, 4) || hasGLExtension("GL_ARB_buffer_storage"))
+	{
+		glext_glBufferStorage = reinterpret_cast<PFNGLEXTBUFFERSTORAGEPROC>(load("glBufferStorage"));
+	}
+
+	GLEXT_ARB_buffer_storage = glext_glBufferStorage != nullptr;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+
+/*
+ * glad is generated for a plain 3.3 core profile, so entry points and enums of newer core versions
+ * and extensions are loaded here instead. Every feature has a flag which is only set when the driver
+ * exposes it, callers must check the flag and keep a 3.3 path.
+ */
+
+/* GL_ARB_get_program_binary (core in 4.1) */
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+typedef void (APIENTRYP PFNGLEXTGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length,
+                                                      GLenum* binaryFormat, void* binary);
+
+typedef void (APIENTRYP PFNGLEXTPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary,
+                                                   GLsizei length);
+
+typedef void (APIENTRYP PFNGLEXTPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+extern int GLEXT_ARB_get_program_binary;
+
+extern PFNGLEXTGETPROGRAMBINARYPROC glext_glGetProgramBinary;
+#define glGetProgramBinary glext_glGetProgramBinary
+
+extern PFNGLEXTPROGRAMBINARYPROC glext_glProgramBinary;
+#define glProgramBinary glext_glProgramBinary
+
+extern PFNGLEXTPROGRAMPARAMETERIPROC glext_glProgramParameteri;
+#define glProgramParameteri glext_glProgramParameteri
+
+/* GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile */
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void (APIENTRYP PFNGLEXTMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+
+extern int GLEXT_KHR_parallel_shader_compile;
+
+extern PFNGLEXTMAXSHADERCOMPILERTHREADSPROC glext_glMaxShaderCompilerThreads;
+#define glMaxShaderCompilerThreads glext_glMaxShaderCompilerThreads
+
+/*
+ * GL_ARB_multi_draw_indirect (core in 4.3), only flagged together with GL_ARB_base_instance (core in 4.2)
+ * because the batched draws pass their draw index as the base instance of each command
+ */
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+typedef void (APIENTRYP PFNGLEXTMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect,
+                                                               GLsizei drawcount, GLsizei stride);
+
+extern int GLEXT_ARB_multi_draw_indirect;
+
+extern PFNGLEXTMULTIDRAWELEMENTSINDIRECTPROC glext_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect glext_glMultiDrawElementsIndirect
+
+/* GL_ARB_buffer_storage (core in 4.4), immutable buffers that can stay mapped while the GPU reads them */
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+typedef void (APIENTRYP PFNGLEXTBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+extern int GLEXT_ARB_buffer_storage;
+
+extern PFNGLEXTBUFFERSTORAGEPROC glext_glBufferStorage;
+#define glBufferStorage glext_glBufferStorage
+
+/* loads all optional entry points, must be called after gladLoadGLLoader with the same loader */
+void loadGLExtensions(GLADloadproc load);
+
+/* returns true if the current context advertises the named extension */
+bool hasGLExtension(const char* name);
+
+/* returns true if the current context is at least the given core version */
+bool hasGLVersion(int major, int minor);
+
+#endif
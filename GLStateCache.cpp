@@ -0,0 +1,326 @@
+#include "GLStateCache.h"
+#include <initializer_list>
+
+GLuint GLStateCache::program = UNKNOWN;
+
+GLuint GLStateCache::vertexArray = UNKNOWN;
+
+GLuint GLStateCache::arrayBuffer = UNKNOWN;
+
+GLuint GLStateCache::elementArrayBuffer = UNKNOWN;
+
+GLuint GLStateCache::uniformBuffer = UNKNOWN;
+
+GLuint GLStateCache::activeUnit = UNKNOWN;
+
+GLuint GLStateCache::textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+
+GLuint GLStateCache::capabilities[CAPABILITY_COUNT];
+
+GLenum GLStateCache::blendSource = UNKNOWN;
+
+GLenum GLStateCache::blendDestination = UNKNOWN;
+
+GLenum GLStateCache::depthFunction = UNKNOWN;
+
+GLuint GLStateCache::depthWrite = UNKNOWN;
+
+GLenum GLStateCache::cullMode = UNKNOWN;
+
+GLStateStats GLStateCache::stats = {};
+
+namespace
+{
+	/* the static arrays can't be initialised to UNKNOWN in place, so they are reset before first use */
+	struct InitialInvalidate
+	{
+		InitialInvalidate()
+		{
+			GLStateCache::invalidate();
+		}
+	} initialInvalidate;
+}
+
+void GLStateCache::useProgram(const GLuint program)
+{
+	if (change(GLStateCache::program, program))
+	{
+		glUseProgram(program);
+	}
+}
+
+void GLStateCache::bindVertexArray(const GLuint vertexArray)
+{
+	if (change(GLStateCache::vertexArray, vertexArray))
+	{
+		glBindVertexArray(vertexArray);
+
+		/* the element array binding belongs to the vertex array */
+		elementArrayBuffer = UNKNOWN;
+	}
+}
+
+void GLStateCache::bindBuffer(const GLenum target, const GLuint buffer)
+{
+	auto shadow = &arrayBuffer;
+
+	if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		shadow = &elementArrayBuffer;
+	}
+	else if (target == GL_UNIFORM_BUFFER)
+	{
+		shadow = &uniformBuffer;
+	}
+	else if (target != GL_ARRAY_BUFFER)
+	{
+		++stats.issued;
+
+		glBindBuffer(target, buffer);
+
+		return;
+	}
+
+	if (change(*shadow, buffer))
+	{
+		glBindBuffer(target, buffer);
+	}
+}
+
+void GLStateCache::bindBufferBase(const GLenum target, const GLuint index, const GLuint buffer)
+{
+	++stats.issued;
+
+	glBindBufferBase(target, index, buffer);
+
+	if (target == GL_UNIFORM_BUFFER)
+	{
+		uniformBuffer = buffer;
+	}
+}
+
+void GLStateCache::bindTexture(const GLuint unit, const GLenum target, const GLuint texture)
+{
+	const auto targetIndex = textureTargetIndex(target);
+
+	if (unit < MAX_TEXTURE_UNITS && targetIndex >= 0)
+	{
+		if (!change(textures[unit][targetIndex], texture))
+		{
+			return;
+		}
+	}
+	else
+	{
+		++stats.issued;
+	}
+
+	activeTexture(unit);
+
+	glBindTexture(target, texture);
+}
+
+void GLStateCache::activeTexture(const GLuint unit)
+{
+	if (change(activeUnit, unit))
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+}
+
+void GLStateCache::setEnabled(const GLenum capability, const bool enabled)
+{
+	const auto index = capabilityIndex(capability);
+
+	if (index >= 0 && !change(capabilities[index], enabled ? GL_TRUE : GL_FALSE))
+	{
+		return;
+	}
+
+	if (index < 0)
+	{
+		++stats.issued;
+	}
+
+	if (enabled)
+	{
+		glEnable(capability);
+	}
+	else
+	{
+		glDisable(capability);
+	}
+}
+
+void GLStateCache::blendFunc(const GLenum source, const GLenum destination)
+{
+	/* one call sets both factors, so count it once */
+	if (blendSource == source && blendDestination == destination)
+	{
+		++stats.skipped;
+
+		return;
+	}
+
+	++stats.issued;
+
+	blendSource = source;
+
+	blendDestination = destination;
+
+	glBlendFunc(source, destination);
+}
+
+void GLStateCache::depthFunc(const GLenum function)
+{
+	if (change(depthFunction, function))
+	{
+		glDepthFunc(function);
+	}
+}
+
+void GLStateCache::depthMask(const bool enabled)
+{
+	if (change(depthWrite, enabled ? GL_TRUE : GL_FALSE))
+	{
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+}
+
+void GLStateCache::cullFace(const GLenum mode)
+{
+	if (change(cullMode, mode))
+	{
+		glCullFace(mode);
+	}
+}
+
+void GLStateCache::invalidate()
+{
+	program = UNKNOWN;
+
+	vertexArray = UNKNOWN;
+
+	arrayBuffer = UNKNOWN;
+
+	elementArrayBuffer = UNKNOWN;
+
+	uniformBuffer = UNKNOWN;
+
+	activeUnit = UNKNOWN;
+
+	for (auto& unit : textures)
+	{
+		for (auto& texture : unit)
+		{
+			texture = UNKNOWN;
+		}
+	}
+
+	for (auto& capability : capabilities)
+	{
+		capability = UNKNOWN;
+	}
+
+	blendSource = UNKNOWN;
+
+	blendDestination = UNKNOWN;
+
+	depthFunction = UNKNOWN;
+
+	depthWrite = UNKNOWN;
+
+	cullMode = UNKNOWN;
+}
+
+void GLStateCache::forgetTexture(const GLuint texture)
+{
+	/* deleting a bound texture reverts the binding to 0 */
+	for (auto& unit : textures)
+	{
+		for (auto& bound : unit)
+		{
+			if (bound == texture)
+			{
+				bound = 0;
+			}
+		}
+	}
+}
+
+void GLStateCache::forgetVertexArray(const GLuint vertexArray)
+{
+	if (GLStateCache::vertexArray == vertexArray)
+	{
+		GLStateCache::vertexArray = 0;
+
+		elementArrayBuffer = UNKNOWN;
+	}
+}
+
+void GLStateCache::forgetBuffer(const GLuint buffer)
+{
+	for (auto shadow : {&arrayBuffer, &elementArrayBuffer, &uniformBuffer})
+	{
+		if (*shadow == buffer)
+		{
+			*shadow = 0;
+		}
+	}
+}
+
+const GLStateStats& GLStateCache::getStats()
+{
+	return stats;
+}
+
+void GLStateCache::resetStats()
+{
+	stats = {};
+}
+
+bool GLStateCache::change(GLuint& shadow, const GLuint value)
+{
+	if (shadow == value)
+	{
+		++stats.skipped;
+
+		return false;
+	}
+
+	++stats.issued;
+
+	shadow = value;
+
+	return true;
+}
+
+int GLStateCache::textureTargetIndex(const GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D:
+		return TEXTURE_TARGET_2D;
+	case GL_TEXTURE_CUBE_MAP:
+		return TEXTURE_TARGET_CUBE_MAP;
+	default:
+		return -1;
+	}
+}
+
+int GLStateCache::capabilityIndex(const GLenum capability)
+{
+	switch (capability)
+	{
+	case GL_BLEND:
+		return CAPABILITY_BLEND;
+	case GL_DEPTH_TEST:
+		return CAPABILITY_DEPTH_TEST;
+	case GL_CULL_FACE:
+		return CAPABILITY_CULL_FACE;
+	case GL_STENCIL_TEST:
+		return CAPABILITY_STENCIL_TEST;
+	default:
+		return -1;
+	}
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <glad/glad.h>
+
+/* calls that reached the driver versus calls dropped because they wouldn't change anything */
+struct GLStateStats
+{
+	unsigned int issued;
+
+	unsigned int skipped;
+};
+
+/*
+ * Shadows the bound program, vertex array, buffers, texture units and the common blend/depth/cull state
+ * and drops calls that wouldn't change it. Everything that binds these must go through here,
+ * call invalidate() after code that touches GL state directly (third party code, debug tools).
+ */
+class GLStateCache
+{
+public:
+	/* number of texture units that are tracked, binds to higher units always reach the driver */
+	static const unsigned int MAX_TEXTURE_UNITS = 32;
+
+	static void useProgram(GLuint program);
+
+	static void bindVertexArray(GLuint vertexArray);
+
+	/* GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER (part of the bound vertex array) and GL_UNIFORM_BUFFER are tracked */
+	static void bindBuffer(GLenum target, GLuint buffer);
+
+	/* glBindBufferBase also replaces the generic binding of the target, keep the shadow in step */
+	static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+	/* GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP are tracked, the active unit is only switched if a bind is needed */
+	static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+	static void activeTexture(GLuint unit);
+
+	/* GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE and GL_STENCIL_TEST are tracked */
+	static void setEnabled(GLenum capability, bool enabled);
+
+	static void blendFunc(GLenum source, GLenum destination);
+
+	static void depthFunc(GLenum function);
+
+	static void depthMask(bool enabled);
+
+	static void cullFace(GLenum mode);
+
+	/* forgets everything, the next call of each kind reaches the driver */
+	static void invalidate();
+
+	/* forget a deleted object, its name may be handed out again */
+	static void forgetTexture(GLuint texture);
+
+	static void forgetVertexArray(GLuint vertexArray);
+
+	static void forgetBuffer(GLuint buffer);
+
+	/* counters since the last resetStats, call it at the start of every frame for per-frame numbers */
+	static const GLStateStats& getStats();
+
+	static void resetStats();
+
+private:
+	enum TrackedTarget
+	{
+		TEXTURE_TARGET_2D,
+		TEXTURE_TARGET_CUBE_MAP,
+		TEXTURE_TARGET_COUNT
+	};
+
+	enum TrackedCapability
+	{
+		CAPABILITY_BLEND,
+		CAPABILITY_DEPTH_TEST,
+		CAPABILITY_CULL_FACE,
+		CAPABILITY_STENCIL_TEST,
+		CAPABILITY_COUNT
+	};
+
+	/* marks a shadow value as unknown so the next call always goes through */
+	static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+	static GLuint program;
+
+	static GLuint vertexArray;
+
+	static GLuint arrayBuffer;
+
+	static GLuint elementArrayBuffer;
+
+	static GLuint uniformBuffer;
+
+	static GLuint activeUnit;
+
+	static GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+
+	static GLuint capabilities[CAPABILITY_COUNT];
+
+	static GLenum blendSource;
+
+	static GLenum blendDestination;
+
+	static GLenum depthFunction;
+
+	static GLuint depthWrite;
+
+	static GLenum cullMode;
+
+	static GLStateStats stats;
+
+	/* compares and updates a shadow value, counts the outcome and returns true if the call has to be issued */
+	static bool change(GLuint& shadow, GLuint value);
+
+	static int textureTargetIndex(GLenum target);
+
+	static int capabilityIndex(GLenum capability);
+};
+
+#endif
@@ -0,0 +1,619 @@
+#include "GeometryArena.h"
+#include "GLStateCache.h"
+#include "Mesh.h"
+#include "glad/glad.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	/* starting sizes, about a megabyte each, enough for a few of the tutorial models before growing */
+	const size_t INITIAL_VERTEX_CAPACITY = 1 << 16;
+
+	const size_t INITIAL_INDEX_CAPACITY = 1 << 18;
+
+	const size_t INDEX_WORD_SIZE = 4;
+
+	/* returned by Pool::allocate when the space above top is too small */
+	const size_t NO_SPACE = SIZE_MAX;
+}
+
+GeometryArena::Pool GeometryArena::vertices;
+
+GeometryArena::Pool GeometryArena::indices;
+
+unsigned int GeometryArena::vertexArray = 0;
+
+unsigned int GeometryArena::drawIndexBuffer = 0;
+
+size_t GeometryArena::drawIndexCapacity = 0;
+
+unsigned int GeometryArena::instanceMatrixBuffer = 0;
+
+unsigned int GeometryArena::generation = 0;
+
+std::vector<GeometryArena::Allocation> GeometryArena::allocations;
+
+std::vector<unsigned int> GeometryArena::freeHandles;
+
+size_t GeometryArena::Pool::allocate(const size_t size)
+{
+	/* first fit in the holes */
+	for (auto i = 0u; i < freeBlocks.size(); ++i)
+	{
+		auto& block = freeBlocks[i];
+
+		if (block.size < size)
+		{
+			continue;
+		}
+
+		const auto offset = block.offset;
+
+		block.offset += size;
+
+		block.size -= size;
+
+		if (block.size == 0)
+		{
+			freeBlocks.erase(freeBlocks.begin() + i);
+		}
+
+		return offset;
+	}
+
+	if (top + size > capacity)
+	{
+		return NO_SPACE;
+	}
+
+	const auto offset = top;
+
+	top += size;
+
+	return offset;
+}
+
+void GeometryArena::Pool::free(const size_t offset, const size_t size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+
+	/* the highest allocation lowers top, together with any hole that then ends at top */
+	if (offset + size == top)
+	{
+		top = offset;
+
+		while (!freeBlocks.empty() && freeBlocks.back().offset + freeBlocks.back().size == top)
+		{
+			top = freeBlocks.back().offset;
+
+			freeBlocks.pop_back();
+		}
+
+		return;
+	}
+
+	auto next = std::lower_bound(freeBlocks.begin(), freeBlocks.end(), offset,
+	                             [](const Block& block, const size_t value) { return block.offset < value; });
+
+	next = freeBlocks.insert(next, Block{offset, size});
+
+	/* merge with the following hole */
+	if (next + 1 != freeBlocks.end() && next->offset + next->size == (next + 1)->offset)
+	{
+		next->size += (next + 1)->size;
+
+		freeBlocks.erase(next + 1);
+	}
+
+	/* and with the preceding one */
+	if (next != freeBlocks.begin() && (next - 1)->offset + (next - 1)->size == next->offset)
+	{
+		(next - 1)->size += next->size;
+
+		freeBlocks.erase(next);
+	}
+}
+
+size_t GeometryArena::Pool::freeBelowTop() const
+{
+	size_t size = 0;
+
+	for (const auto& block : freeBlocks)
+	{
+		size += block.size;
+	}
+
+	return size;
+}
+
+unsigned int GeometryArena::allocate(const PackedVertex* vertexData, const size_t vertexCount, const void* indexData,
+                                     const size_t indexBytes)
+{
+	if (vertexArray == 0)
+	{
+		initialize();
+	}
+
+	const auto indexWords = (indexBytes + INDEX_WORD_SIZE - 1) / INDEX_WORD_SIZE;
+
+	auto vertexOffset = vertices.allocate(vertexCount);
+
+	if (vertexOffset == NO_SPACE)
+	{
+		reallocate(vertices, sizeof(PackedVertex), std::max(vertices.capacity * 2, vertices.top + vertexCount),
+		           {Pool::Block{0, vertices.top}}, {0});
+
+		vertexOffset = vertices.allocate(vertexCount);
+	}
+
+	auto indexOffset = indices.allocate(indexWords);
+
+	if (indexOffset == NO_SPACE)
+	{
+		reallocate(indices, INDEX_WORD_SIZE, std::max(indices.capacity * 2, indices.top + indexWords),
+		           {Pool::Block{0, indices.top}}, {0});
+
+		indexOffset = indices.allocate(indexWords);
+	}
+
+	/* upload through the copy target, binding the element buffer would change the bound vertex array */
+	GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, vertices.buffer);
+
+	glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * sizeof(PackedVertex), vertexCount * sizeof(PackedVertex),
+	                vertexData);
+
+	GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, indices.buffer);
+
+	glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * INDEX_WORD_SIZE, indexBytes, indexData);
+
+	unsigned int handle;
+
+	if (!freeHandles.empty())
+	{
+		handle = freeHandles.back();
+
+		freeHandles.pop_back();
+	}
+	else
+	{
+		handle = static_cast<unsigned int>(allocations.size());
+
+		allocations.emplace_back();
+	}
+
+	auto& allocation = allocations[handle];
+
+	allocation.range.baseVertex = vertexOffset;
+
+	allocation.range.vertexCount = vertexCount;
+
+	allocation.range.indexOffset = indexOffset * INDEX_WORD_SIZE;
+
+	allocation.range.indexBytes = indexBytes;
+
+	allocation.indexWords = indexWords;
+
+	allocation.live = true;
+
+	return handle;
+}
+
+void GeometryArena::free(const unsigned int allocation)
+{
+	if (allocation >= allocations.size() || !allocations[allocation].live)
+	{
+		return;
+	}
+
+	auto& entry = allocations[allocation];
+
+	vertices.free(entry.range.baseVertex, entry.range.vertexCount);
+
+	indices.free(entry.range.indexOffset / INDEX_WORD_SIZE, entry.indexWords);
+
+	entry.live = false;
+
+	freeHandles.push_back(allocation);
+}
+
+const GeometryRange& GeometryArena::getRange(const unsigned int allocation)
+{
+	return allocations[allocation].range;
+}
+
+void GeometryArena::read(const unsigned int allocation, std::vector<PackedVertex>& vertexData,
+                         std::vector<unsigned char>& indexData)
+{
+	const auto& range = allocations[allocation].range;
+
+	vertexData.resize(range.vertexCount);
+
+	indexData.resize(range.indexBytes);
+
+	GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, vertices.buffer);
+
+	glGetBufferSubData(GL_COPY_READ_BUFFER, range.baseVertex * sizeof(PackedVertex), range.vertexCount * sizeof(PackedVertex),
+	                   vertexData.data());
+
+	GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, indices.buffer);
+
+	glGetBufferSubData(GL_COPY_READ_BUFFER, range.indexOffset, range.indexBytes, indexData.data());
+}
+
+unsigned int GeometryArena::getVertexArray()
+{
+	return vertexArray;
+}
+
+bool GeometryArena::compact(const float maxFragmentation)
+{
+	const auto holes = vertices.freeBelowTop() * sizeof(PackedVertex) + indices.freeBelowTop() * INDEX_WORD_SIZE;
+
+	const auto used = vertices.top * sizeof(PackedVertex) + indices.top * INDEX_WORD_SIZE;
+
+	if (used == 0 || holes <= maxFragmentation * used)
+	{
+		return false;
+	}
+
+	/* live allocations in buffer order, so every range moves down and the order is kept */
+	std::vector<unsigned int> live;
+
+	for (auto i = 0u; i < allocations.size(); ++i)
+	{
+		if (allocations[i].live)
+		{
+			live.push_back(i);
+		}
+	}
+
+	std::vector<Pool::Block> vertexFrom, indexFrom;
+
+	std::vector<size_t> vertexTo, indexTo;
+
+	size_t vertexTop = 0;
+
+	size_t indexTop = 0;
+
+	std::sort(live.begin(), live.end(), [](const unsigned int a, const unsigned int b)
+	{
+		return allocations[a].range.baseVertex < allocations[b].range.baseVertex;
+	});
+
+	for (const auto handle : live)
+	{
+		auto& range = allocations[handle].range;
+
+		vertexFrom.push_back(Pool::Block{range.baseVertex, range.vertexCount});
+
+		vertexTo.push_back(vertexTop);
+
+		range.baseVertex = vertexTop;
+
+		vertexTop += range.vertexCount;
+	}
+
+	std::sort(live.begin(), live.end(), [](const unsigned int a, const unsigned int b)
+	{
+		return allocations[a].range.indexOffset < allocations[b].range.indexOffset;
+	});
+
+	for (const auto handle : live)
+	{
+		auto& allocation = allocations[handle];
+
+		indexFrom.push_back(Pool::Block{allocation.range.indexOffset / INDEX_WORD_SIZE, allocation.indexWords});
+
+		indexTo.push_back(indexTop);
+
+		allocation.range.indexOffset = indexTop * INDEX_WORD_SIZE;
+
+		indexTop += allocation.indexWords;
+	}
+
+	/* shrink as well, keeping some room so the next load doesn't grow straight away */
+	reallocate(vertices, sizeof(PackedVertex), std::max(INITIAL_VERTEX_CAPACITY, vertexTop + vertexTop / 2), vertexFrom,
+	           vertexTo);
+
+	reallocate(indices, INDEX_WORD_SIZE, std::max(INITIAL_INDEX_CAPACITY, indexTop + indexTop / 2), indexFrom, indexTo);
+
+	vertices.top = vertexTop;
+
+	vertices.freeBlocks.clear();
+
+	indices.top = indexTop;
+
+	indices.freeBlocks.clear();
+
+	++generation;
+
+	return true;
+}
+
+GeometryArenaStats GeometryArena::getStats()
+{
+	GeometryArenaStats stats;
+
+	stats.allocations = allocations.size() - freeHandles.size();
+
+	stats.vertexCapacity = vertices.capacity * sizeof(PackedVertex);
+
+	stats.vertexUsed = (vertices.top - vertices.freeBelowTop()) * sizeof(PackedVertex);
+
+	stats.indexCapacity = indices.capacity * INDEX_WORD_SIZE;
+
+	stats.indexUsed = (indices.top - indices.freeBelowTop()) * INDEX_WORD_SIZE;
+
+	return stats;
+}
+
+unsigned int GeometryArena::getGeneration()
+{
+	return generation;
+}
+
+void GeometryArena::reserveDrawIndices(const size_t count)
+{
+	if (count <= drawIndexCapacity)
+	{
+		return;
+	}
+
+	if (vertexArray == 0)
+	{
+		initialize();
+	}
+
+	drawIndexCapacity = std::max(count, std::max<size_t>(drawIndexCapacity * 2, 256));
+
+	std::vector<uint32_t> drawIndices(drawIndexCapacity);
+
+	for (auto i = 0u; i < drawIndices.size(); ++i)
+	{
+		drawIndices[i] = i;
+	}
+
+	const auto created = drawIndexBuffer == 0;
+
+	if (created)
+	{
+		glGenBuffers(1, &drawIndexBuffer);
+	}
+
+	/* respecifying the store keeps the buffer name, so the vertex array only needs setting up once */
+	GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, drawIndexBuffer);
+
+	glBufferData(GL_COPY_WRITE_BUFFER, drawIndices.size() * sizeof(uint32_t), drawIndices.data(), GL_STATIC_DRAW);
+
+	if (created)
+	{
+		setupVertexArray();
+	}
+}
+
+void GeometryArena::setInstanceMatrices(const unsigned int buffer)
+{
+	if (vertexArray == 0)
+	{
+		initialize();
+	}
+
+	if (buffer == instanceMatrixBuffer)
+	{
+		return;
+	}
+
+	instanceMatrixBuffer = buffer;
+
+	setupVertexArray();
+}
+
+void GeometryArena::shutdown()
+{
+	if (vertexArray == 0)
+	{
+		return;
+	}
+
+	GLStateCache::forgetVertexArray(vertexArray);
+
+	glDeleteVertexArrays(1, &vertexArray);
+
+	for (auto pool : {&vertices, &indices})
+	{
+		GLStateCache::forgetBuffer(pool->buffer);
+
+		glDeleteBuffers(1, &pool->buffer);
+
+		*pool = Pool();
+	}
+
+	if (drawIndexBuffer != 0)
+	{
+		GLStateCache::forgetBuffer(drawIndexBuffer);
+
+		glDeleteBuffers(1, &drawIndexBuffer);
+	}
+
+	vertexArray = 0;
+
+	drawIndexBuffer = 0;
+
+	drawIndexCapacity = 0;
+
+	instanceMatrixBuffer = 0;
+
+	++generation;
+
+	allocations.clear();
+
+	freeHandles.clear();
+}
+
+void GeometryArena::initialize()
+{
+	glGenVertexArrays(1, &vertexArray);
+
+	reallocate(vertices, sizeof(PackedVertex), INITIAL_VERTEX_CAPACITY, {}, {});
+
+	reallocate(indices, INDEX_WORD_SIZE, INITIAL_INDEX_CAPACITY, {}, {});
+}
+
+void GeometryArena::reallocate(Pool& pool, const size_t unitSize, const size_t capacity,
+                               const std::vector<Pool::Block>& from, const std::vector<size_t>& to)
+{
+	unsigned int buffer;
+
+	glGenBuffers(1, &buffer);
+
+	GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+	glBufferData(GL_COPY_WRITE_BUFFER, capacity * unitSize, nullptr, GL_STATIC_DRAW);
+
+	if (pool.buffer != 0)
+	{
+		GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, pool.buffer);
+
+		for (auto i = 0u; i < from.size(); ++i)
+		{
+			if (from[i].size > 0)
+			{
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, from[i].offset * unitSize,
+				                    to[i] * unitSize, from[i].size * unitSize);
+			}
+		}
+
+		GLStateCache::forgetBuffer(pool.buffer);
+
+		glDeleteBuffers(1, &pool.buffer);
+	}
+
+	pool.buffer = buffer;
+
+	pool.capacity = capacity;
+
+	setupVertexArray();
+}
+
+void GeometryArena::setupVertexArray()
+{
+	GLStateCache::bindVertexArray(vertexArray);
+
+	GLStateCache::bindBuffer(GL_ARRAY_BUFFER, vertices.buffer);
+
+	GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.buffer);
+
+	/* set the vertex attribute pointers, the layout of PackedVertex */
+	// ------------------------------
+	/* vertex Positions, w holds the tangent frame handedness */
+	glEnableVertexAttribArray(0);
+
+	glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex),
+	                      reinterpret_cast<void*>(offsetof(PackedVertex, Position)));
+
+	/* vertex normals */
+	glEnableVertexAttribArray(1);
+
+	glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex),
+	                      reinterpret_cast<void*>(offsetof(PackedVertex, Normal)));
+
+	/* vertex texture coords */
+	glEnableVertexAttribArray(2);
+
+	glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+	                      reinterpret_cast<void*>(offsetof(PackedVertex, TexCoords)));
+
+	/* vertex tangent, the bitangent is derived from it */
+	glEnableVertexAttribArray(3);
+
+	glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex),
+	                      reinterpret_cast<void*>(offsetof(PackedVertex, Tangent)));
+
+	/* draw index, one value per instance */
+	if (drawIndexBuffer != 0)
+	{
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+
+		glEnableVertexAttribArray(DRAW_INDEX_ATTRIBUTE);
+
+		glVertexAttribIPointer(DRAW_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(uint32_t), nullptr);
+
+		glVertexAttribDivisor(DRAW_INDEX_ATTRIBUTE, 1);
+	}
+
+	/* instance matrices, a mat4 takes one attribute per column */
+	for (auto column = 0u; column < 4; ++column)
+	{
+		const auto attribute = INSTANCE_MATRIX_ATTRIBUTE + column;
+
+		if (instanceMatrixBuffer == 0)
+		{
+			glDisableVertexAttribArray(attribute);
+
+			continue;
+		}
+
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, instanceMatrixBuffer);
+
+		glEnableVertexAttribArray(attribute);
+
+		glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+		                      reinterpret_cast<void*>(column * sizeof(glm::vec4)));
+
+		glVertexAttribDivisor(attribute, 1);
+	}
+
+	GLStateCache::bindVertexArray(0);
+}
+
+GeometryAllocation::GeometryAllocation(const unsigned int handle) : handle(handle)
+{
+}
+
+GeometryAllocation::~GeometryAllocation()
+{
+	reset();
+}
+
+GeometryAllocation::GeometryAllocation(GeometryAllocation&& other) noexcept : handle(other.handle)
+{
+	other.handle = GeometryArena::INVALID;
+}
+
+GeometryAllocation& GeometryAllocation::operator=(GeometryAllocation&& other) noexcept
+{
+	if (this != &other)
+	{
+		reset();
+
+		handle = other.handle;
+
+		other.handle = GeometryArena::INVALID;
+	}
+
+	return *this;
+}
+
+unsigned int GeometryAllocation::get() const
+{
+	return handle;
+}
+
+bool GeometryAllocation::isValid() const
+{
+	return handle != GeometryArena::INVALID;
+}
+
+void GeometryAllocation::reset()
+{
+	if (handle != GeometryArena::INVALID)
+	{
+		GeometryArena::free(handle);
+
+		handle = GeometryArena::INVALID;
+	}
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+struct PackedVertex;
+
+/* where an allocation lives inside the shared buffers */
+struct GeometryRange
+{
+	/* first vertex, passed as base vertex so the indices stay relative to the mesh */
+	size_t baseVertex = 0;
+
+	size_t vertexCount = 0;
+
+	/* byte offset into the index buffer, passed as the indices pointer of the draw */
+	size_t indexOffset = 0;
+
+	size_t indexBytes = 0;
+};
+
+/* capacity versus what is in use, holes left by freed allocations count as free */
+struct GeometryArenaStats
+{
+	size_t allocations = 0;
+
+	size_t vertexCapacity = 0;
+
+	size_t vertexUsed = 0;
+
+	size_t indexCapacity = 0;
+
+	size_t indexUsed = 0;
+};
+
+/*
+ * Vertex and index data of every Mesh sub-allocated from one vertex buffer and one index buffer,
+ * with a single vertex array for the PackedVertex format (the only format meshes are uploaded in).
+ * Consecutive meshes then draw with glDrawElementsBaseVertex without switching vertex arrays or buffers.
+ * The buffers grow by doubling. Freed ranges go to a free list (first fit, neighbours are merged) and
+ * compact() moves the live allocations together once the holes waste too much.
+ * Allocations are referred to by handle, offsets can change when the arena grows or compacts.
+ */
+class GeometryArena
+{
+public:
+	static const unsigned int INVALID = 0xFFFFFFFF;
+
+	/* per instance attribute of the vertex array that holds the draw index, see reserveDrawIndices */
+	static const unsigned int DRAW_INDEX_ATTRIBUTE = 7;
+
+	/* first of the four per instance attributes (8 to 11) that hold a mat4 per instance, see setInstanceMatrices */
+	static const unsigned int INSTANCE_MATRIX_ATTRIBUTE = 8;
+
+	/* copies a mesh into the arena, indexBytes may hold 16 or 32 bit indices. returns the allocation handle */
+	static unsigned int allocate(const PackedVertex* vertices, size_t vertexCount, const void* indices, size_t indexBytes);
+
+	/* releases an allocation, its space is reused by later allocations */
+	static void free(unsigned int allocation);
+
+	static const GeometryRange& getRange(unsigned int allocation);
+
+	/* copies an allocation back from the buffers, for tools that store what was uploaded (ModelCooker) */
+	static void read(unsigned int allocation, std::vector<PackedVertex>& vertexData, std::vector<unsigned char>& indexData);
+
+	/* the vertex array that every allocation is drawn with */
+	static unsigned int getVertexArray();
+
+	/*
+	 * packs the live allocations to the start of new buffers if more than maxFragmentation of the used space
+	 * is holes, returns true if it did. Called when models unload.
+	 */
+	static bool compact(float maxFragmentation = 0.25f);
+
+	static GeometryArenaStats getStats();
+
+	/* changes whenever allocations move, anything that caches ranges (indirect commands) rebuilds when it does */
+	static unsigned int getGeneration();
+
+	/*
+	 * feeds DRAW_INDEX_ATTRIBUTE from an identity buffer (0, 1, 2, ...) of at least count entries, with a divisor of 1.
+	 * the base instance of an indirect draw command then selects the value, so the shader knows which draw it is in.
+	 */
+	static void reserveDrawIndices(size_t count);
+
+	/*
+	 * feeds INSTANCE_MATRIX_ATTRIBUTE from a buffer of tightly packed mat4s with a divisor of 1, for instanced draws
+	 * (Mesh::DrawInstanced). the buffer stays owned by the caller, pass 0 before deleting it
+	 */
+	static void setInstanceMatrices(unsigned int buffer);
+
+	/* deletes the buffers and the vertex array, every allocation becomes invalid */
+	static void shutdown();
+
+private:
+	/* space in units (vertices or 4 byte index words) of one buffer */
+	struct Pool
+	{
+		unsigned int buffer = 0;
+
+		size_t capacity = 0;
+
+		/* end of the highest allocation, everything above it is free */
+		size_t top = 0;
+
+		struct Block
+		{
+			size_t offset;
+
+			size_t size;
+		};
+
+		/* holes below top, sorted by offset */
+		std::vector<Block> freeBlocks;
+
+		size_t allocate(size_t size);
+
+		void free(size_t offset, size_t size);
+
+		size_t freeBelowTop() const;
+	};
+
+	struct Allocation
+	{
+		GeometryRange range;
+
+		/* sizes in pool units, the index range is rounded up to whole words */
+		size_t indexWords = 0;
+
+		bool live = false;
+	};
+
+	/* 20 bytes per unit, the size of PackedVertex */
+	static Pool vertices;
+
+	/* 4 bytes per unit so 32 bit indices stay aligned */
+	static Pool indices;
+
+	static unsigned int vertexArray;
+
+	static unsigned int drawIndexBuffer;
+
+	static size_t drawIndexCapacity;
+
+	static unsigned int instanceMatrixBuffer;
+
+	static unsigned int generation;
+
+	static std::vector<Allocation> allocations;
+
+	static std::vector<unsigned int> freeHandles;
+
+	static void initialize();
+
+	/* moves a pool into a new buffer of the given capacity, copying the given ranges (in units) to their new offsets */
+	static void reallocate(Pool& pool, size_t unitSize, size_t capacity, const std::vector<Pool::Block>& from,
+	                       const std::vector<size_t>& to);
+
+	/* points the vertex array at the current buffers */
+	static void setupVertexArray();
+};
+
+/* owns one allocation of the arena and frees it when it goes away, so it can be moved but not copied */
+class GeometryAllocation
+{
+public:
+	GeometryAllocation() = default;
+
+	explicit GeometryAllocation(unsigned int handle);
+
+	~GeometryAllocation();
+
+	GeometryAllocation(const GeometryAllocation&) = delete;
+
+	GeometryAllocation& operator=(const GeometryAllocation&) = delete;
+
+	/* the source is left empty */
+	GeometryAllocation(GeometryAllocation&& other) noexcept;
+
+	GeometryAllocation& operator=(GeometryAllocation&& other) noexcept;
+
+	/* the arena handle, GeometryArena::INVALID if empty */
+	unsigned int get() const;
+
+	bool isValid() const;
+
+	/* frees the allocation now */
+	void reset();
+
+private:
+	unsigned int handle = GeometryArena::INVALID;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* 64 bit FNV-1a, used for cache keys and content hashes (not cryptographic) */
+const uint64_t HASH_SEED = 14695981039346656037ull;
+
+inline uint64_t hashBytes(const void* data, const size_t size, uint64_t hash = HASH_SEED)
+{
+	const auto bytes = static_cast<const unsigned char*>(data);
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+/* includes the length so that moving text from one string to the next changes the hash */
+inline uint64_t hashString(const std::string& value, const uint64_t hash = HASH_SEED)
+{
+	const auto length = static_cast<uint64_t>(value.size());
+
+	return hashBytes(value.data(), value.size(), hashBytes(&length, sizeof(length), hash));
+}
+
+#endif
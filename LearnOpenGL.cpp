@@ -11,7 +11,17 @@
 #include <vector>
 #include <string>
 
+#include "Benchmarks.h"
+#include "Camera.h"
+#include "FrameUniforms.h"
+#include "GLExtensions.h"
+#include "GLStateCache.h"
 #include "Shader.h"
+#include "ShaderBundle.h"
+#include "ShaderCooker.h"
+#include "ShaderReloader.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
 
 /* settings */
 const auto scr_width = 800;
@@ -40,8 +50,23 @@ GLuint VAO, VBO;
 
 void RenderText(const Shader& shader, std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color);
 
-int main()
+int main(int argc, char* argv[])
 {
+    /* LearnOpenGL --pack-shaders <directory> <bundle> packs the loose files without cooking them, it needs no window */
+    if (argc > 3 && std::string(argv[1]) == "--pack-shaders")
+    {
+        return ShaderBundle::pack(argv[2], argv[3]) ? 0 : 1;
+    }
+
+    /* LearnOpenGL --cook-shaders <directory> <manifest> <bundle> only needs a context to validate the shaders */
+    const auto cookShaders = argc > 4 && std::string(argv[1]) == "--cook-shaders";
+
+    /* release builds load the packed shaders, without a bundle the loose files are used. cooking reads the loose files and replaces the bundle */
+    if (!cookShaders)
+    {
+        ShaderBundle::open("Shaders.bundle");
+    }
+
     /* glfw: initialize and configure */
     // ------------------------------
     glfwInit();
@@ -54,12 +79,18 @@ int main()
 
     glfwWindowHint(GLFW_RESIZABLE,GL_FALSE);
 
+    if (cookShaders)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
+
     /* glfw: window creation */
     // ------------------------------
     const auto window = glfwCreateWindow(scr_width, scr_height, "LearnOpenGL", nullptr, nullptr);
 
     if (window == nullptr)
     {
+        /* the shaders can't be validated without a context, packing them anyway is an explicit opt-in (--pack-shaders) */
         std::cout << "Failed to create GLFW window" << std::endl;
 
         glfwTerminate();
@@ -77,20 +108,53 @@ int main()
         return -1;
     }
 
+    /* load entry points newer than the 3.3 core profile glad was generated for */
+    loadGLExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+
+    if (cookShaders)
+    {
+        const auto cooked = ShaderCooker::cook(argv[2], argv[3], argv[4]);
+
+        glfwTerminate();
+
+        return cooked ? 0 : 1;
+    }
+
+    /* LearnOpenGL --benchmark <name> runs a benchmark instead of the demo */
+    if (argc > 2 && std::string(argv[1]) == "--benchmark")
+    {
+        if (!runBenchmark(argv[2]))
+        {
+            std::cout << "Unknown benchmark: " << argv[2] << std::endl;
+        }
+
+        glfwTerminate();
+
+        return 0;
+    }
+
     // Define the viewport dimensions
     glViewport(0, 0, scr_width, scr_height);
 
     /* configure global opengl state */
     // ------------------------------
-    glEnable(GL_CULL_FACE);
+    GLStateCache::setEnabled(GL_CULL_FACE, true);
 
-    glEnable(GL_BLEND);
+    GLStateCache::setEnabled(GL_BLEND, true);
 
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache::blendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
 
     /* build and compile our shader program */
     // ------------------------------
-    const Shader shader("Shaders/text.vs", "Shaders/text.fs");
+    Shader shader("Shaders/text.vs", "Shaders/text.fs");
+
+    /* edits to the text shaders show up without a restart, bundled shaders can't change */
+    ShaderReloader shaderReloader(ThreadPool::shared());
+
+    if (!ShaderBundle::isOpen())
+    {
+        shaderReloader.watch(shader, "Shaders/text.vs", "Shaders/text.fs");
+    }
 
     const auto projection = glm::ortho(0.f, static_cast<GLfloat>(scr_width), 0.f, static_cast<GLfloat>(scr_height));
 
@@ -98,6 +162,11 @@ int main()
 
     shader.setMat4("projection", projection);
 
+    /* camera and lights of every 3D program come from the shared uniform blocks, uploaded once per frame */
+    const Camera camera(glm::vec3(0.f, 0.f, 3.f));
+
+    FrameUniforms frameUniforms;
+
     /* FreeType */
     FT_Library ft;
 
@@ -135,7 +204,7 @@ int main()
 
         glGenTextures(1, &texture);
 
-        glBindTexture(GL_TEXTURE_2D, texture);
+        GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture);
 
         glTexImage2D(
             GL_TEXTURE_2D,
@@ -169,8 +238,6 @@ int main()
         Characters.insert(std::pair<GLchar, Character>(c, character));
     }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-
     /* Destroy FreeType once we're finished */
     FT_Done_Face(face);
 
@@ -181,9 +248,9 @@ int main()
 
     glGenBuffers(1, &VBO);
 
-    glBindVertexArray(VAO);
+    GLStateCache::bindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLStateCache::bindBuffer(GL_ARRAY_BUFFER, VBO);
 
     glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, nullptr,GL_DYNAMIC_DRAW);
 
@@ -191,10 +258,6 @@ int main()
 
     glVertexAttribPointer(0, 4,GL_FLOAT,GL_FALSE, 4 * sizeof(GLfloat), nullptr);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glBindVertexArray(0);
-
     /* render loop */
     // ------------------------------
     while (!glfwWindowShouldClose(window))
@@ -202,6 +265,24 @@ int main()
         /* Check and call events */
         glfwPollEvents();
 
+        /* state cache and uniform upload counters are per frame */
+        GLStateCache::resetStats();
+
+        Shader::resetUploadStats();
+
+        shaderReloader.update();
+
+        /* textures decoded since the last frame replace their placeholders */
+        TextureLoader::update();
+
+        frameUniforms.setCamera(glm::perspective(glm::radians(camera.Zoom),
+                                                 static_cast<float>(scr_width) / static_cast<float>(scr_height), 0.1f,
+                                                 100.f), camera.GetViewMatrix(), camera.Position);
+
+        frameUniforms.frame.time = static_cast<float>(glfwGetTime());
+
+        frameUniforms.upload();
+
         /* render */
         // ------------------------------
         glClearColor(0.2f, 0.3f, 0.3f, 1.f);
@@ -234,9 +315,9 @@ void RenderText(const Shader& shader, std::string text, GLfloat x, GLfloat y, GL
 
     shader.setVec3("textColor", color.x, color.y, color.z);
 
-    glActiveTexture(GL_TEXTURE0);
+    GLStateCache::bindVertexArray(VAO);
 
-    glBindVertexArray(VAO);
+    GLStateCache::bindBuffer(GL_ARRAY_BUFFER, VBO);
 
     /* Iterate through all characters */
     for (const auto c : text)
@@ -262,25 +343,19 @@ void RenderText(const Shader& shader, std::string text, GLfloat x, GLfloat y, GL
         };
 
         /* Render glyph texture over quad */
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
+        GLStateCache::bindTexture(0, GL_TEXTURE_2D, ch.TextureID);
 
         /* Update content of VBO memory */
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
         /*  Be sure to use glBufferSubData and not glBufferData*/
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-
         /* Render quad */
+        shader.flush();
+
         glDrawArrays(GL_TRIANGLES, 0, 6);
 
         /* Now advance cursors for next glyph (note that advance is number of 1/64 pixels) */
         /* Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels)) */
         x += (ch.Advance >> 6) * scale;
     }
-
-    glBindVertexArray(0);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -0,0 +1,162 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	take(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+
+		take(other);
+	}
+
+	return *this;
+}
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+	                   nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	GetFileSizeEx(file, &fileSize);
+
+	length = static_cast<size_t>(fileSize.QuadPart);
+
+	mapping = length > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+
+	base = mapping != nullptr ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+	const auto descriptor = ::open(path.c_str(), O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+
+	length = fstat(descriptor, &status) == 0 ? static_cast<size_t>(status.st_size) : 0;
+
+	if (length > 0)
+	{
+		const auto address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+		base = address != MAP_FAILED ? static_cast<const char*>(address) : nullptr;
+	}
+
+	/* the mapping stays valid after the descriptor is closed */
+	::close(descriptor);
+#endif
+
+	if (base == nullptr)
+	{
+		close();
+
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (base != nullptr)
+	{
+		UnmapViewOfFile(base);
+	}
+
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);
+	}
+
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+	}
+
+	mapping = nullptr;
+
+	file = INVALID_HANDLE_VALUE;
+#else
+	if (base != nullptr)
+	{
+		munmap(const_cast<char*>(base), length);
+	}
+#endif
+
+	base = nullptr;
+
+	length = 0;
+}
+
+const char* MappedFile::data() const
+{
+	return base;
+}
+
+size_t MappedFile::size() const
+{
+	return length;
+}
+
+bool MappedFile::contains(const size_t offset, const size_t size) const
+{
+	return offset <= length && size <= length - offset;
+}
+
+void MappedFile::take(MappedFile& other)
+{
+	base = other.base;
+
+	length = other.length;
+
+	other.base = nullptr;
+
+	other.length = 0;
+
+#ifdef _WIN32
+	file = other.file;
+
+	mapping = other.mapping;
+
+	other.file = INVALID_HANDLE_VALUE;
+
+	other.mapping = nullptr;
+#endif
+}
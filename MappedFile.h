@@ -0,0 +1,51 @@
+#pragma once
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/* a whole file mapped read only, unmapped when the object goes away (move-only) */
+class MappedFile
+{
+public:
+	MappedFile() = default;
+
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept;
+
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	/* maps a file, returns false if it is missing or empty */
+	bool open(const std::string& path);
+
+	void close();
+
+	const char* data() const;
+
+	size_t size() const;
+
+	/* true if [offset, offset + size) lies inside the file */
+	bool contains(size_t offset, size_t size) const;
+
+private:
+	const char* base = nullptr;
+
+	size_t length = 0;
+
+#ifdef _WIN32
+	void* file = reinterpret_cast<void*>(-1);
+
+	void* mapping = nullptr;
+#endif
+
+	void take(MappedFile& other);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "Material.h"
+#include "GLStateCache.h"
+
+const char* textureTypeName(const Texture_Type type)
+{
+	switch (type)
+	{
+	case Texture_Type::DIFFUSE:
+		return "texture_diffuse";
+	case Texture_Type::SPECULAR:
+		return "texture_specular";
+	case Texture_Type::NORMAL:
+		return "texture_normal";
+	case Texture_Type::HEIGHT:
+		return "texture_height";
+	case Texture_Type::REFLECTION:
+		return "texture_reflection";
+	}
+
+	return "texture_unknown";
+}
+
+MaterialBindingTable::MaterialBindingTable(const Shader& shader, const std::vector<Texture>& textures) :
+	shader(&shader), program(shader.ID), positionScale(shader.getUniform("positionScale")),
+	positionOffset(shader.getUniform("positionOffset"))
+{
+	/* running number (the N in texture_diffuseN) per texture type */
+	unsigned int numbers[static_cast<size_t>(Texture_Type::REFLECTION) + 1] = {};
+
+	bindings.reserve(textures.size());
+
+	for (auto i = 0u; i < textures.size(); ++i)
+	{
+		const auto& texture = textures[i];
+
+		const auto number = numbers[static_cast<size_t>(texture.type)]++;
+
+		const auto sampler = shader.getUniform(textureTypeName(texture.type) + std::to_string(number));
+
+		if (sampler.isValid())
+		{
+			bindings.push_back(TextureBinding{texture.id, i, sampler});
+		}
+	}
+}
+
+bool MaterialBindingTable::matches(const Shader& shader) const
+{
+	return this->shader == &shader && program == shader.ID;
+}
+
+const Shader* MaterialBindingTable::getShader() const
+{
+	return shader;
+}
+
+UniformHandle MaterialBindingTable::getPositionScale() const
+{
+	return positionScale;
+}
+
+UniformHandle MaterialBindingTable::getPositionOffset() const
+{
+	return positionOffset;
+}
+
+void MaterialBindingTable::bind(const Shader& shader) const
+{
+	/* the state cache skips units that already hold the right texture */
+	for (const auto& binding : bindings)
+	{
+		shader.setInt(binding.sampler, binding.unit);
+
+		GLStateCache::bindTexture(binding.unit, GL_TEXTURE_2D, binding.texture);
+	}
+}
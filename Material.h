@@ -0,0 +1,79 @@
+#pragma once
+
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Shader.h"
+
+/* what a mesh texture is used for, it also names the sampler the texture feeds (texture_diffuseN, ...) */
+enum class Texture_Type : uint8_t
+{
+	DIFFUSE,
+	SPECULAR,
+	NORMAL,
+	HEIGHT,
+	REFLECTION
+};
+
+/* sampler name prefix of a texture type ("texture_diffuse") */
+const char* textureTypeName(Texture_Type type);
+
+struct Texture
+{
+	unsigned int id;
+
+	Texture_Type type;
+
+	std::string path;
+};
+
+/* a texture, the unit it is bound to and the sampler that reads it */
+struct TextureBinding
+{
+	unsigned int texture;
+
+	unsigned int unit;
+
+	UniformHandle sampler;
+};
+
+/*
+ * The textures of one mesh resolved against one program, done once when the pair first draws:
+ * texture i goes to unit i and feeds the sampler named after its type and its number among the textures of
+ * that type (texture_diffuse0, texture_diffuse1, texture_specular0, ...). Textures the program doesn't sample are dropped.
+ * Binding is then a loop over ids and units, the sampler values go through handles and only reach GL when they change.
+ * The table also holds the handles of the mesh bounds uniforms (positionScale, positionOffset) Mesh sets on every draw.
+ */
+class MaterialBindingTable
+{
+public:
+	MaterialBindingTable(const Shader& shader, const std::vector<Texture>& textures);
+
+	/* false once the shader relinked (hot reload) or for another shader, the table has to be resolved again */
+	bool matches(const Shader& shader) const;
+
+	void bind(const Shader& shader) const;
+
+	const Shader* getShader() const;
+
+	/* handles of the packed position bounds, invalid if the program takes float positions */
+	UniformHandle getPositionScale() const;
+
+	UniformHandle getPositionOffset() const;
+
+private:
+	const Shader* shader;
+
+	GLuint program;
+
+	std::vector<TextureBinding> bindings;
+
+	UniformHandle positionScale;
+
+	UniformHandle positionOffset;
+};
+
+#endif
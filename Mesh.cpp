@@ -1,140 +1,502 @@
 #include "Mesh.h"
+#include "Camera.h"
+#include "GeometryArena.h"
+#include "GLStateCache.h"
 #include "glad/glad.h"
 #include "Shader.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+#include <utility>
 
-Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
-           const std::vector<Texture>& textures)
+namespace
 {
-	this->vertices = vertices;
+	/* octahedral encoding of a unit vector, folds the lower hemisphere over the diagonals */
+	glm::vec2 octahedralEncode(const glm::vec3& v)
+	{
+		const auto length = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+
+		/* degenerate vectors (missing normals or tangents) encode as +z */
+		if (length <= 0.0f)
+		{
+			return glm::vec2(0.0f);
+		}
+
+		auto p = glm::vec2(v.x, v.y) / length;
+
+		if (v.z < 0.0f)
+		{
+			p = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+			              (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+		}
+
+		return p;
+	}
+}
+
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures,
+           std::vector<MeshLod> lods, std::vector<Meshlet> meshlets) : vertices(std::move(vertices)),
+                                                                      textures(std::move(textures)), lods(std::move(lods)),
+                                                                      meshlets(std::move(meshlets))
+{
+	meshletBounds = Meshlets::packBounds(this->meshlets);
 
-	this->indices = indices;
+	if (this->lods.empty())
+	{
+		this->lods.push_back(MeshLod{0, static_cast<uint32_t>(indices.size()), 0.f});
+	}
 
-	this->textures = textures;
+	/* 16 bit indices address vertices 0 to 65535, which covers nearly every submesh */
+	if (this->vertices.size() <= 65536)
+	{
+		shortIndices.assign(indices.begin(), indices.end());
+
+		indexType = GL_UNSIGNED_SHORT;
+	}
+	else
+	{
+		this->indices = std::move(indices);
+
+		indexType = GL_UNSIGNED_INT;
+	}
 
 	/* now that we have all the required data, set the vertex buffers and its attribute pointers. */
 	setupMesh();
 }
 
+Mesh::Mesh(const PackedMesh& packed, std::vector<Texture> textures, std::vector<MeshLod> lods,
+           std::vector<Meshlet> meshlets) : textures(std::move(textures)), indexType(packed.indexType),
+                                            positionScale(packed.positionScale), positionOffset(packed.positionOffset),
+                                            lods(std::move(lods)), meshlets(std::move(meshlets))
+{
+	if (this->lods.empty())
+	{
+		this->lods.push_back(MeshLod{0, static_cast<uint32_t>(packed.indexCount), 0.f});
+	}
+
+	meshletBounds = Meshlets::packBounds(this->meshlets);
+
+	const auto indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	geometry = GeometryAllocation(GeometryArena::allocate(packed.vertices, packed.vertexCount, packed.indices,
+	                                                      packed.indexCount * indexSize));
+
+	VAO = GeometryArena::getVertexArray();
+}
+
 void Mesh::Draw(const Shader& shader) const
 {
-	/* bind appropriate textures */
-	unsigned int diffuseNr = 0;
+	if (!geometry.isValid())
+	{
+		return;
+	}
+
+	bindTextures(shader);
+
+	drawGeometry(shader);
+}
+
+void Mesh::DrawInstanced(const Shader& shader, const unsigned int instanceCount) const
+{
+	if (!geometry.isValid() || instanceCount == 0)
+	{
+		return;
+	}
 
-	unsigned int specularNr = 0;
+	bindTextures(shader);
 
-	unsigned int normalNr = 0;
+	drawRange(shader, lods[0], instanceCount);
+}
 
-	unsigned int heightNr = 0;
+void Mesh::drawGeometry(const Shader& shader) const
+{
+	if (!geometry.isValid())
+	{
+		return;
+	}
 
-	unsigned int reflectionNr = 0;
+	drawRange(shader, lods[0]);
+}
 
-	for (auto i = 0u; i < textures.size(); ++i)
+void Mesh::drawLod(const Shader& shader, const unsigned int lod) const
+{
+	if (!geometry.isValid())
 	{
-		/* active proper texture unit before binding */
-		glActiveTexture(GL_TEXTURE0 + i);
+		return;
+	}
 
-		/* retrieve texture number (the N in diffuse_textureN) */
-		std::string number;
+	bindTextures(shader);
 
-		auto name = textures[i].type;
+	drawRange(shader, lods[std::min<size_t>(lod, lods.size() - 1)]);
+}
 
-		if (name == "texture_diffuse")
-		{
-			/* transfer unsigned int to stream */
-			number = std::to_string(diffuseNr++);
-		}
-		else if (name == "texture_specular")
+void Mesh::drawRange(const Shader& shader, const MeshLod& lod, const unsigned int instanceCount) const
+{
+	bindGeometry(shader);
+
+	const auto& range = GeometryArena::getRange(geometry.get());
+
+	const auto indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	const auto offset = reinterpret_cast<void*>(range.indexOffset + lod.indexOffset * indexSize);
+
+	if (instanceCount == 1)
+	{
+		glDrawElementsBaseVertex(GL_TRIANGLES, lod.indexCount, indexType, offset, static_cast<GLint>(range.baseVertex));
+
+		return;
+	}
+
+	glDrawElementsInstancedBaseVertex(GL_TRIANGLES, lod.indexCount, indexType, offset,
+	                                  static_cast<GLsizei>(instanceCount), static_cast<GLint>(range.baseVertex));
+}
+
+void Mesh::bindGeometry(const Shader& shader) const
+{
+	/* all meshes share the arena's vertex array so it is only bound once across them */
+	GLStateCache::bindVertexArray(GeometryArena::getVertexArray());
+
+	const auto& table = getBindingTable(shader);
+
+	shader.setVec3(table.getPositionScale(), positionScale);
+
+	shader.setVec3(table.getPositionOffset(), positionOffset);
+
+	shader.flush();
+}
+
+const std::vector<MeshLod>& Mesh::getLods() const
+{
+	return lods;
+}
+
+unsigned int Mesh::selectLod(const glm::mat4& model, const Camera& camera, const float viewportHeight,
+                             const float errorPixels) const
+{
+	if (lods.size() == 1)
+	{
+		return 0;
+	}
+
+	/* bounding sphere of the packed position bounds, in world space */
+	const auto scale = std::max(glm::length(glm::vec3(model[0])),
+	                            std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+	const auto center = glm::vec3(model * glm::vec4(positionOffset + positionScale * 0.5f, 1.f));
+
+	const auto radius = glm::length(positionScale) * 0.5f * scale;
+
+	/* the nearest point of the sphere decides, from inside it only the full mesh will do */
+	const auto distance = glm::length(center - camera.Position) - radius;
+
+	if (distance <= 0.f)
+	{
+		return 0;
+	}
+
+	auto selected = 0u;
+
+	for (auto i = 1u; i < lods.size(); ++i)
+	{
+		if (camera.GetProjectedSize(lods[i].error * scale, distance, viewportHeight) > errorPixels)
 		{
-			/* transfer unsigned int to stream */
-			number = std::to_string(specularNr++);
+			break;
 		}
-		else if (name == "texture_normal")
+
+		selected = i;
+	}
+
+	return selected;
+}
+
+void Mesh::buildMeshlets()
+{
+	if (!hasCpuGeometry())
+	{
+		return;
+	}
+
+	meshlets = Meshlets::build(vertices, getIndices());
+
+	meshletBounds = Meshlets::packBounds(meshlets);
+}
+
+const std::vector<Meshlet>& Mesh::getMeshlets() const
+{
+	return meshlets;
+}
+
+MeshletCullStats Mesh::drawCulled(const Shader& shader, const glm::mat4& model, const glm::mat4& viewProjection,
+                                  const glm::vec3& viewPosition) const
+{
+	if (meshlets.empty() || !geometry.isValid())
+	{
+		Draw(shader);
+
+		return MeshletCullStats();
+	}
+
+	/* cull in model space */
+	const auto viewer = glm::vec3(glm::inverse(model) * glm::vec4(viewPosition, 1.f));
+
+	const auto stats = Meshlets::cull(meshletBounds, viewProjection * model, viewer, visibleMeshlets);
+
+	if (stats.visible == 0)
+	{
+		return stats;
+	}
+
+	/* neighbouring meshlets are neighbouring index ranges, so each run of visible ones is a single range */
+	const auto& range = GeometryArena::getRange(geometry.get());
+
+	const auto indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	rangeCounts.clear();
+
+	rangeOffsets.clear();
+
+	auto previousVisible = false;
+
+	for (auto i = 0u; i < meshlets.size(); ++i)
+	{
+		const auto visible = visibleMeshlets[i] != 0;
+
+		if (visible && previousVisible)
 		{
-			/* transfer unsigned int to stream */
-			number = std::to_string(normalNr++);
+			rangeCounts.back() += meshlets[i].triangleCount * 3;
 		}
-		else if (name == "texture_height")
+		else if (visible)
 		{
-			/* transfer unsigned int to stream */
-			name = std::to_string(heightNr++);
+			rangeCounts.push_back(meshlets[i].triangleCount * 3);
+
+			rangeOffsets.push_back(reinterpret_cast<const void*>(range.indexOffset + meshlets[i].indexOffset * indexSize));
 		}
-		else if (name == "texture_reflection")
+
+		previousVisible = visible;
+	}
+
+	bindTextures(shader);
+
+	bindGeometry(shader);
+
+	rangeBaseVertices.assign(rangeCounts.size(), static_cast<int>(range.baseVertex));
+
+	glMultiDrawElementsBaseVertex(GL_TRIANGLES, rangeCounts.data(), indexType, rangeOffsets.data(),
+	                              static_cast<GLsizei>(rangeCounts.size()), rangeBaseVertices.data());
+
+	return stats;
+}
+
+void Mesh::bindTextures(const Shader& shader) const
+{
+	getBindingTable(shader).bind(shader);
+}
+
+const MaterialBindingTable& Mesh::getBindingTable(const Shader& shader) const
+{
+	for (const auto& table : bindingTables)
+	{
+		if (table.matches(shader))
 		{
-			/* transfer unsigned int to stream */
-			name = std::to_string(reflectionNr++);
+			return table;
 		}
+	}
+
+	/* a table of the same shader was resolved against its previous program (before a hot reload) */
+	bindingTables.erase(std::remove_if(bindingTables.begin(), bindingTables.end(),
+	                                   [&shader](const MaterialBindingTable& table) { return table.getShader() == &shader; }),
+	                    bindingTables.end());
+
+	/* first draw with this program, resolve which sampler each texture feeds */
+	bindingTables.emplace_back(shader, textures);
+
+	return bindingTables.back();
+}
+
+unsigned int Mesh::getGeometry() const
+{
+	return geometry.get();
+}
+
+unsigned int Mesh::getIndexType() const
+{
+	return indexType;
+}
+
+const glm::vec3& Mesh::getPositionScale() const
+{
+	return positionScale;
+}
 
-		/* now set the sampler to the correct texture unit */
-		shader.setInt(name + number, i);
+const glm::vec3& Mesh::getPositionOffset() const
+{
+	return positionOffset;
+}
 
-		/* and finally bind the texture */
-		glBindTexture(GL_TEXTURE_2D, textures[i].id);
+void Mesh::release()
+{
+	geometry.reset();
+}
+
+void Mesh::releaseCpuGeometry()
+{
+	/* swap with empty vectors, clear() would keep the capacity */
+	std::vector<Vertex>().swap(vertices);
+
+	std::vector<unsigned int>().swap(indices);
+
+	std::vector<uint16_t>().swap(shortIndices);
+}
+
+bool Mesh::hasCpuGeometry() const
+{
+	return !vertices.empty();
+}
+
+size_t Mesh::getIndexCount() const
+{
+	return lods[0].indexCount;
+}
+
+std::vector<unsigned int> Mesh::getIndices() const
+{
+	/* nothing left to widen after releaseCpuGeometry */
+	if (!hasCpuGeometry())
+	{
+		return std::vector<unsigned int>();
+	}
+
+	const auto count = getIndexCount();
+
+	if (indexType == GL_UNSIGNED_SHORT)
+	{
+		return std::vector<unsigned int>(shortIndices.begin(), shortIndices.begin() + count);
+	}
+
+	return std::vector<unsigned int>(indices.begin(), indices.begin() + count);
+}
+
+MeshMemoryStats Mesh::getMemoryStats() const
+{
+	MeshMemoryStats stats;
+
+	if (!geometry.isValid())
+	{
+		return stats;
 	}
 
-	/* draw mesh */
-	glBindVertexArray(VAO);
+	/* taken from the arena allocation, so it still works after releaseCpuGeometry */
+	const auto& range = GeometryArena::getRange(geometry.get());
 
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
+	stats.vertexBytes = range.vertexCount * sizeof(PackedVertex);
 
-	glBindVertexArray(0);
+	stats.vertexBytesSaved = range.vertexCount * (sizeof(Vertex) - sizeof(PackedVertex));
 
-	/* always good practice to set everything back to defaults once configured. */
-	glActiveTexture(GL_TEXTURE0);
+	stats.indexBytes = range.indexBytes;
+
+	if (indexType == GL_UNSIGNED_SHORT)
+	{
+		stats.indexBytesSaved = range.indexBytes / sizeof(uint16_t) * (sizeof(unsigned int) - sizeof(uint16_t));
+	}
+
+	return stats;
 }
 
-void Mesh::setupMesh()
+void MeshMemoryStats::add(const MeshMemoryStats& other)
 {
-	/* create buffers/arrays */
-	glGenVertexArrays(1, &VAO);
+	vertexBytes += other.vertexBytes;
 
-	glGenBuffers(1, &VBO);
+	indexBytes += other.indexBytes;
 
-	glGenBuffers(1, &EBO);
+	vertexBytesSaved += other.vertexBytesSaved;
 
-	glBindVertexArray(VAO);
+	indexBytesSaved += other.indexBytesSaved;
+}
 
-	/* load data into vertex buffers */
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+std::vector<PackedVertex> Mesh::packVertices()
+{
+	auto minimum = glm::vec3(0.0f);
 
-	/*
-	 * A great thing about structs is that their memory layout is sequential for all its items.
-	 * The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
-	 * again translates to 3/2 floats which translates to a byte array.
-	 */
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+	auto maximum = glm::vec3(0.0f);
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	if (!vertices.empty())
+	{
+		minimum = maximum = vertices[0].Position;
+	}
 
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+	for (const auto& vertex : vertices)
+	{
+		minimum = glm::min(minimum, vertex.Position);
+
+		maximum = glm::max(maximum, vertex.Position);
+	}
+
+	positionOffset = minimum;
+
+	positionScale = maximum - minimum;
+
+	/* a flat axis has no extent, every vertex then packs to 0 on it */
+	const auto inverseScale = glm::vec3(positionScale.x > 0.0f ? 1.0f / positionScale.x : 0.0f,
+	                                    positionScale.y > 0.0f ? 1.0f / positionScale.y : 0.0f,
+	                                    positionScale.z > 0.0f ? 1.0f / positionScale.z : 0.0f);
+
+	std::vector<PackedVertex> packed(vertices.size());
+
+	for (auto i = 0u; i < vertices.size(); ++i)
+	{
+		const auto& vertex = vertices[i];
+
+		auto& out = packed[i];
+
+		const auto position = (vertex.Position - positionOffset) * inverseScale;
+
+		out.Position[0] = glm::packUnorm1x16(position.x);
+
+		out.Position[1] = glm::packUnorm1x16(position.y);
 
-	/* set the vertex attribute pointers */
-	// ------------------------------
-	/* vertex Positions */
-	glEnableVertexAttribArray(0);
+		out.Position[2] = glm::packUnorm1x16(position.z);
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), static_cast<void*>(nullptr));
+		/* the bitangent is rebuilt in the shader as cross(N, T) times the handedness */
+		const auto handedness = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent);
 
-	/* vertex normals */
-	glEnableVertexAttribArray(1);
+		out.Position[3] = handedness >= 0.0f ? 0xFFFF : 0;
 
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, Normal)));
+		const auto normal = octahedralEncode(vertex.Normal);
 
-	/* vertex texture coords */
-	glEnableVertexAttribArray(2);
+		out.Normal[0] = static_cast<int16_t>(glm::packSnorm1x16(normal.x));
 
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-	                      reinterpret_cast<void*>(offsetof(Vertex, TexCoords)));
+		out.Normal[1] = static_cast<int16_t>(glm::packSnorm1x16(normal.y));
 
-	/* vertex tangent */
-	glEnableVertexAttribArray(3);
+		out.TexCoords[0] = glm::packHalf1x16(vertex.TexCoords.x);
 
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, Tangent)));
+		out.TexCoords[1] = glm::packHalf1x16(vertex.TexCoords.y);
 
-	/* vertex bitangent */
-	glEnableVertexAttribArray(4);
+		const auto tangent = octahedralEncode(vertex.Tangent);
 
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-	                      reinterpret_cast<void*>(offsetof(Vertex, Bitangent)));
+		out.Tangent[0] = static_cast<int16_t>(glm::packSnorm1x16(tangent.x));
+
+		out.Tangent[1] = static_cast<int16_t>(glm::packSnorm1x16(tangent.y));
+	}
+
+	return packed;
+}
+
+void Mesh::setupMesh()
+{
+	/* vertices are quantized on upload, the shaders decode them through Shaders/include/mesh_vertex.glsl */
+	const auto packed = packVertices();
+
+	/* sub-allocate from the shared buffers instead of creating a vertex array and buffers per mesh */
+	if (indexType == GL_UNSIGNED_SHORT)
+	{
+		geometry = GeometryAllocation(GeometryArena::allocate(packed.data(), packed.size(), shortIndices.data(),
+		                                                      shortIndices.size() * sizeof(uint16_t)));
+	}
+	else
+	{
+		geometry = GeometryAllocation(GeometryArena::allocate(packed.data(), packed.size(), indices.data(),
+		                                                      indices.size() * sizeof(unsigned int)));
+	}
 
-	glBindVertexArray(0);
+	VAO = GeometryArena::getVertexArray();
 }
@@ -3,11 +3,17 @@
 #ifndef MESH_H
 #define MESH_H
 
+#include "GeometryArena.h"
+#include "Material.h"
+#include "Meshlet.h"
+#include "MeshSimplifier.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+class Camera;
 class Shader;
 
 struct Vertex
@@ -23,13 +29,56 @@ struct Vertex
 	glm::vec3 Bitangent;
 };
 
-struct Texture
+/*
+ * compact form of Vertex that Mesh uploads (20 bytes instead of 56), decoded by Shaders/include/mesh_vertex.glsl:
+ * position normalised to the mesh bounds, octahedral normal and tangent, half float texture coords and
+ * the bitangent reduced to the handedness of the tangent frame in Position[3]
+ */
+struct PackedVertex
 {
-	unsigned int id;
+	uint16_t Position[4];
 
-	std::string type;
+	int16_t Normal[2];
 
-	std::string path;
+	uint16_t TexCoords[2];
+
+	int16_t Tangent[2];
+};
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must stay tightly packed");
+
+/* a mesh in the layout it is uploaded in, as stored by ModelCooker. the pointers only need to live until the upload */
+struct PackedMesh
+{
+	const PackedVertex* vertices;
+
+	size_t vertexCount;
+
+	/* 16 or 32 bit depending on indexType, all levels of detail */
+	const void* indices;
+
+	size_t indexCount;
+
+	unsigned int indexType;
+
+	glm::vec3 positionScale;
+
+	glm::vec3 positionOffset;
+};
+
+/* GPU memory taken by a mesh's buffers, and what the compact formats save over float vertices and 32 bit indices */
+struct MeshMemoryStats
+{
+	size_t vertexBytes = 0;
+
+	size_t indexBytes = 0;
+
+	size_t vertexBytesSaved = 0;
+
+	size_t indexBytesSaved = 0;
+
+	/* adds another mesh's numbers, for model wide totals */
+	void add(const MeshMemoryStats& other);
 };
 
 class Mesh
@@ -38,26 +87,153 @@ public:
 	/* Mesh Data */
 	std::vector<Vertex> vertices;
 
+	/*
+	 * the index buffer is stored in the narrowest width that can address every vertex:
+	 * shortIndices for meshes of up to 65536 vertices (most of them), indices only for larger ones.
+	 * it holds the levels of detail one after the other, the full mesh first
+	 */
 	std::vector<unsigned int> indices;
 
+	std::vector<uint16_t> shortIndices;
+
 	std::vector<Texture> textures;
 
+	/* the geometry arena's vertex array, shared by all meshes */
 	unsigned int VAO{};
 
 	/* Functions */
-	/* constructor */
-	Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
-	     const std::vector<Texture>& textures);
+	/*
+	 * constructor, lods are the ranges of indices made by MeshSimplifier::buildLodChain (none: indices is a single level),
+	 * meshlets those of Meshlets::build for the full mesh (none: call buildMeshlets for drawCulled).
+	 * pass the vectors with std::move when they aren't needed afterwards, they are taken over instead of copied
+	 */
+	Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures,
+	     std::vector<MeshLod> lods = std::vector<MeshLod>(), std::vector<Meshlet> meshlets = std::vector<Meshlet>());
+
+	/* uploads an already packed mesh, it has no CPU copy (like after releaseCpuGeometry) */
+	Mesh(const PackedMesh& packed, std::vector<Texture> textures, std::vector<MeshLod> lods, std::vector<Meshlet> meshlets);
+
+	/* the mesh owns its space in the geometry arena, it is returned when the mesh goes away */
+	Mesh(const Mesh&) = delete;
+
+	Mesh& operator=(const Mesh&) = delete;
+
+	Mesh(Mesh&&) = default;
+
+	Mesh& operator=(Mesh&&) = default;
 
 	/* render the mesh */
 	void Draw(const Shader& shader) const;
 
+	/* renders instanceCount copies, the shader reads per instance data the caller set up (GeometryArena::setInstanceMatrices) */
+	void DrawInstanced(const Shader& shader, unsigned int instanceCount) const;
+
+	/* binds the textures to units 0..n and points the sampler uniforms at them, through the program's binding table */
+	void bindTextures(const Shader& shader) const;
+
+	/* the draw part of Draw, for callers that bound the textures already */
+	void drawGeometry(const Shader& shader) const;
+
+	/* arena allocation and index type (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT), for batched draws */
+	unsigned int getGeometry() const;
+
+	unsigned int getIndexType() const;
+
+	/* mapping of the packed positions back to model space */
+	const glm::vec3& getPositionScale() const;
+
+	const glm::vec3& getPositionOffset() const;
+
+	/* levels of detail, the full mesh first, each coarser than the one before */
+	const std::vector<MeshLod>& getLods() const;
+
+	/*
+	 * the coarsest level whose error, projected by the camera onto a viewport viewportHeight pixels high,
+	 * stays within errorPixels. model is the mesh's transform, its largest scale scales the error
+	 */
+	unsigned int selectLod(const glm::mat4& model, const Camera& camera, float viewportHeight, float errorPixels) const;
+
+	/* Draw with one level of detail */
+	void drawLod(const Shader& shader, unsigned int lod) const;
+
+	/* splits the mesh into meshlets for drawCulled, call it once the index order is final (and with the CPU copy) */
+	void buildMeshlets();
+
+	const std::vector<Meshlet>& getMeshlets() const;
+
+	/*
+	 * draws only the meshlets inside the frustum that face the viewer, as few index ranges as possible.
+	 * model is the transform the shader is given, viewPosition is in world space. without meshlets it is Draw.
+	 */
+	MeshletCullStats drawCulled(const Shader& shader, const glm::mat4& model, const glm::mat4& viewProjection,
+	                            const glm::vec3& viewPosition) const;
+
+	/* returns the mesh's space in the geometry arena now instead of on destruction, it can't be drawn afterwards */
+	void release();
+
+	/*
+	 * frees vertices and indices once they are uploaded, drawing only needs the GPU copy.
+	 * getIndices() is empty afterwards, so build meshlets and levels of detail first
+	 */
+	void releaseCpuGeometry();
+
+	/* true until releaseCpuGeometry */
+	bool hasCpuGeometry() const;
+
+	/* number of indices of the full mesh, whichever width they are stored in */
+	size_t getIndexCount() const;
+
+	/* the indices of the full mesh widened to 32 bit, for code that processes the triangles on the CPU */
+	std::vector<unsigned int> getIndices() const;
+
+	MeshMemoryStats getMemoryStats() const;
+
 private:
 	/* Render data */
-	unsigned int VBO{}, EBO{};
+	/* allocation in the geometry arena holding the vertices and indices */
+	GeometryAllocation geometry;
+
+	/* GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, matches the vector that holds the indices */
+	unsigned int indexType{};
+
+	/* maps the normalised packed positions back to model space: position = offset + packed * scale */
+	glm::vec3 positionScale{};
+
+	glm::vec3 positionOffset{};
+
+	/* ranges of the index buffer, level 0 is the full mesh */
+	std::vector<MeshLod> lods;
+
+	std::vector<Meshlet> meshlets;
+
+	MeshletBounds meshletBounds;
+
+	/* per frame scratch of drawCulled, kept so culling doesn't allocate */
+	mutable std::vector<uint8_t> visibleMeshlets;
+
+	mutable std::vector<int> rangeCounts;
+
+	mutable std::vector<const void*> rangeOffsets;
+
+	mutable std::vector<int> rangeBaseVertices;
+
+	/* texture bindings and uniform handles per program the mesh was drawn with, resolved on the first draw with each */
+	mutable std::vector<MaterialBindingTable> bindingTables;
 
 	/* Functions */
 	/* initializes all the buffer objects/arrays */
 	void setupMesh();
+
+	/* the textures and uniform handles of a program, resolved on its first draw with this mesh */
+	const MaterialBindingTable& getBindingTable(const Shader& shader) const;
+
+	/* binds the vertex array and sets the position bounds, everything but the textures and the draw call */
+	void bindGeometry(const Shader& shader) const;
+
+	/* draws the indices of one level of detail, textures must be bound */
+	void drawRange(const Shader& shader, const MeshLod& lod, unsigned int instanceCount = 1) const;
+
+	/* quantizes the vertices into the layout of PackedVertex */
+	std::vector<PackedVertex> packVertices();
 };
 #endif
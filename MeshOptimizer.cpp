@@ -0,0 +1,503 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+	/* LRU cache size modelled by the Forsyth scores */
+	const auto FORSYTH_CACHE_SIZE = 32u;
+
+	const auto LAST_TRIANGLE_SCORE = 0.75f;
+
+	const auto CACHE_DECAY_POWER = 1.5f;
+
+	const auto VALENCE_BOOST_SCALE = 2.f;
+
+	const auto VALENCE_BOOST_POWER = 0.5f;
+
+	const auto NEVER = std::numeric_limits<unsigned int>::max();
+
+	/* vertices used by the last triangle score a fixed amount, so the next triangle doesn't favour any of them */
+	float vertexScore(const int cachePosition, const unsigned int remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+		{
+			return -1.f;
+		}
+
+		auto score = 0.f;
+
+		if (cachePosition >= 0)
+		{
+			score = cachePosition < 3
+				        ? LAST_TRIANGLE_SCORE
+				        : std::pow(1.f - static_cast<float>(cachePosition - 3) / static_cast<float>(FORSYTH_CACHE_SIZE - 3),
+				                   CACHE_DECAY_POWER);
+		}
+
+		/* vertices with few triangles left are finished first, so they leave the working set */
+		return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+	}
+
+	/* FIFO cache simulation based on time stamps, a vertex is cached while fewer than size misses happened since its own */
+	class FifoCache
+	{
+	public:
+		FifoCache(const size_t vertexCount, const unsigned int size) : size(size), time(size + 1),
+		                                                              timestamps(vertexCount, 0)
+		{
+		}
+
+		/* returns true on a miss */
+		bool access(const unsigned int vertex)
+		{
+			if (time - timestamps[vertex] <= size)
+			{
+				return false;
+			}
+
+			timestamps[vertex] = time++;
+
+			return true;
+		}
+
+		void flush()
+		{
+			time += size + 1;
+		}
+
+	private:
+		unsigned int size;
+
+		unsigned int time;
+
+		std::vector<unsigned int> timestamps;
+	};
+}
+
+float VertexCacheStats::acmr() const
+{
+	return triangleCount > 0 ? static_cast<float>(transformedCount) / triangleCount : 0.f;
+}
+
+float VertexCacheStats::atvr() const
+{
+	return vertexCount > 0 ? static_cast<float>(transformedCount) / vertexCount : 0.f;
+}
+
+void VertexCacheStats::add(const VertexCacheStats& other)
+{
+	triangleCount += other.triangleCount;
+
+	vertexCount += other.vertexCount;
+
+	transformedCount += other.transformedCount;
+}
+
+void MeshOptimizer::optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	optimizeVertexCache(indices, vertices.size());
+
+	optimizeOverdraw(indices, vertices);
+
+	optimizeVertexFetch(vertices, indices);
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, const size_t vertexCount)
+{
+	const auto triangleCount = indices.size() / 3;
+
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	/* triangles of every vertex, the first remaining[v] entries are the ones not emitted yet */
+	std::vector<unsigned int> remaining(vertexCount, 0);
+
+	for (auto i = 0u; i < triangleCount * 3; ++i)
+	{
+		++remaining[indices[i]];
+	}
+
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+
+	for (auto v = 0u; v < vertexCount; ++v)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+
+	{
+		auto fill = offsets;
+
+		for (auto i = 0u; i < triangleCount * 3; ++i)
+		{
+			adjacency[fill[indices[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<int> cachePositions(vertexCount, -1);
+
+	std::vector<float> vertexScores(vertexCount);
+
+	for (auto v = 0u; v < vertexCount; ++v)
+	{
+		vertexScores[v] = vertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+
+	std::vector<bool> emitted(triangleCount, false);
+
+	auto best = 0u;
+
+	for (auto t = 0u; t < triangleCount; ++t)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+			vertexScores[indices[t * 3 + 2]];
+
+		if (triangleScores[t] > triangleScores[best])
+		{
+			best = t;
+		}
+	}
+
+	std::vector<unsigned int> cache;
+
+	std::vector<unsigned int> nextCache;
+
+	std::vector<unsigned int> result;
+
+	result.reserve(triangleCount * 3);
+
+	/* fallback when no cached vertex has triangles left, unemitted triangles before it are all done */
+	auto cursor = 0u;
+
+	while (result.size() < triangleCount * 3)
+	{
+		emitted[best] = true;
+
+		const auto triangle = &indices[best * 3];
+
+		nextCache.assign(triangle, triangle + 3);
+
+		for (auto i = 0; i < 3; ++i)
+		{
+			const auto vertex = triangle[i];
+
+			result.push_back(vertex);
+
+			/* move the triangle out of the vertex's remaining range */
+			const auto begin = adjacency.begin() + offsets[vertex];
+
+			const auto end = begin + remaining[vertex];
+
+			std::iter_swap(std::find(begin, end, best), end - 1);
+
+			--remaining[vertex];
+		}
+
+		for (const auto vertex : cache)
+		{
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+			{
+				nextCache.push_back(vertex);
+			}
+		}
+
+		/* rescore everything that moved, including the vertices that just fell out */
+		for (auto i = 0u; i < nextCache.size(); ++i)
+		{
+			const auto vertex = nextCache[i];
+
+			cachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+
+			const auto score = vertexScore(cachePositions[vertex], remaining[vertex]);
+
+			const auto delta = score - vertexScores[vertex];
+
+			vertexScores[vertex] = score;
+
+			for (auto a = offsets[vertex]; a < offsets[vertex] + remaining[vertex]; ++a)
+			{
+				triangleScores[adjacency[a]] += delta;
+			}
+		}
+
+		if (nextCache.size() > FORSYTH_CACHE_SIZE)
+		{
+			nextCache.resize(FORSYTH_CACHE_SIZE);
+		}
+
+		cache.swap(nextCache);
+
+		/* the next triangle is the best one touching the cache */
+		auto bestScore = -std::numeric_limits<float>::max();
+
+		auto found = false;
+
+		for (const auto vertex : cache)
+		{
+			for (auto a = offsets[vertex]; a < offsets[vertex] + remaining[vertex]; ++a)
+			{
+				const auto candidate = adjacency[a];
+
+				if (triangleScores[candidate] > bestScore)
+				{
+					bestScore = triangleScores[candidate];
+
+					best = candidate;
+
+					found = true;
+				}
+			}
+		}
+
+		if (!found)
+		{
+			while (cursor < triangleCount && emitted[cursor])
+			{
+				++cursor;
+			}
+
+			best = cursor;
+		}
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+                                     const float threshold)
+{
+	const auto triangleCount = indices.size() / 3;
+
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	/*
+	 * 1. hard boundaries, where the cache order starts over (a triangle missing all three vertices).
+	 * the first triangle always starts a cluster, a degenerate one can't miss three times
+	 */
+	std::vector<unsigned int> hardBoundaries(1, 0);
+
+	{
+		FifoCache cache(vertices.size(), SIMULATED_CACHE_SIZE);
+
+		for (auto t = 0u; t < triangleCount; ++t)
+		{
+			auto misses = 0;
+
+			for (auto i = 0; i < 3; ++i)
+			{
+				misses += cache.access(indices[t * 3 + i]) ? 1 : 0;
+			}
+
+			if (misses == 3 && t > 0)
+			{
+				hardBoundaries.push_back(t);
+			}
+		}
+
+		hardBoundaries.push_back(static_cast<unsigned int>(triangleCount));
+	}
+
+	/* 2. soft boundaries, split a cluster where the part so far is about as cache friendly as the whole cluster */
+	std::vector<unsigned int> clusters;
+
+	for (auto c = 0u; c + 1 < hardBoundaries.size(); ++c)
+	{
+		const auto start = hardBoundaries[c];
+
+		const auto end = hardBoundaries[c + 1];
+
+		FifoCache cache(vertices.size(), SIMULATED_CACHE_SIZE);
+
+		auto clusterMisses = 0u;
+
+		for (auto t = start; t < end; ++t)
+		{
+			for (auto i = 0; i < 3; ++i)
+			{
+				clusterMisses += cache.access(indices[t * 3 + i]) ? 1 : 0;
+			}
+		}
+
+		const auto clusterAcmr = static_cast<float>(clusterMisses) / (end - start);
+
+		cache.flush();
+
+		clusters.push_back(start);
+
+		auto misses = 0u;
+
+		auto clusterStart = start;
+
+		for (auto t = start; t < end; ++t)
+		{
+			for (auto i = 0; i < 3; ++i)
+			{
+				misses += cache.access(indices[t * 3 + i]) ? 1 : 0;
+			}
+
+			if (t + 1 < end && static_cast<float>(misses) / (t + 1 - clusterStart) <= clusterAcmr * threshold)
+			{
+				clusters.push_back(t + 1);
+
+				clusterStart = t + 1;
+
+				misses = 0;
+
+				cache.flush();
+			}
+		}
+	}
+
+	clusters.push_back(static_cast<unsigned int>(triangleCount));
+
+	/* 3. area weighted centroid and normal of every cluster */
+	const auto clusterCount = clusters.size() - 1;
+
+	std::vector<glm::vec3> centroids(clusterCount);
+
+	std::vector<glm::vec3> normals(clusterCount);
+
+	glm::vec3 meshCentroid(0.f);
+
+	auto meshArea = 0.f;
+
+	for (auto c = 0u; c < clusterCount; ++c)
+	{
+		glm::vec3 centroid(0.f);
+
+		glm::vec3 normal(0.f);
+
+		auto area = 0.f;
+
+		for (auto t = clusters[c]; t < clusters[c + 1]; ++t)
+		{
+			const auto& p0 = vertices[indices[t * 3]].Position;
+
+			const auto& p1 = vertices[indices[t * 3 + 1]].Position;
+
+			const auto& p2 = vertices[indices[t * 3 + 2]].Position;
+
+			const auto triangleNormal = glm::cross(p1 - p0, p2 - p0);
+
+			const auto triangleArea = glm::length(triangleNormal);
+
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.f);
+
+			normal += triangleNormal;
+
+			area += triangleArea;
+		}
+
+		meshCentroid += centroid;
+
+		meshArea += area;
+
+		centroids[c] = area > 0.f ? centroid / area : centroid;
+
+		normals[c] = normal;
+	}
+
+	if (meshArea > 0.f)
+	{
+		meshCentroid /= meshArea;
+	}
+
+	/* 4. clusters facing away from the centre are likely to occlude the others, draw them first */
+	std::vector<float> sortKeys(clusterCount);
+
+	std::vector<unsigned int> order(clusterCount);
+
+	for (auto c = 0u; c < clusterCount; ++c)
+	{
+		const auto length = glm::length(normals[c]);
+
+		sortKeys[c] = length > 0.f ? glm::dot(centroids[c] - meshCentroid, normals[c] / length) : 0.f;
+
+		order[c] = c;
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](const unsigned int a, const unsigned int b)
+	{
+		return sortKeys[a] > sortKeys[b];
+	});
+
+	std::vector<unsigned int> result;
+
+	result.reserve(indices.size());
+
+	for (const auto c : order)
+	{
+		result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+	}
+
+	/* the clusters have to cover every triangle exactly once, keep the cache order if they don't */
+	if (result.size() != indices.size())
+	{
+		std::cout << "ERROR::MESH_OPTIMIZER::OVERDRAW_CLUSTERS_LOST_TRIANGLES " << result.size() / 3 << "/" <<
+			triangleCount << std::endl;
+
+		return;
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	std::vector<unsigned int> remap(vertices.size(), NEVER);
+
+	std::vector<Vertex> result;
+
+	result.reserve(vertices.size());
+
+	for (auto& index : indices)
+	{
+		if (remap[index] == NEVER)
+		{
+			remap[index] = static_cast<unsigned int>(result.size());
+
+			result.push_back(vertices[index]);
+		}
+
+		index = remap[index];
+	}
+
+	vertices.swap(result);
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int>& indices, const size_t vertexCount,
+                                                   const unsigned int cacheSize)
+{
+	VertexCacheStats stats;
+
+	stats.triangleCount = indices.size() / 3;
+
+	FifoCache cache(vertexCount, cacheSize);
+
+	std::vector<bool> referenced(vertexCount, false);
+
+	for (const auto index : indices)
+	{
+		stats.transformedCount += cache.access(index) ? 1 : 0;
+
+		if (!referenced[index])
+		{
+			referenced[index] = true;
+
+			++stats.vertexCount;
+		}
+	}
+
+	return stats;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+#include "Mesh.h"
+
+/* post-transform vertex cache behaviour of an index buffer, simulated with a FIFO cache */
+struct VertexCacheStats
+{
+	size_t triangleCount = 0;
+
+	/* vertices referenced by the index buffer */
+	size_t vertexCount = 0;
+
+	/* cache misses, each one runs the vertex shader */
+	size_t transformedCount = 0;
+
+	/* average cache miss ratio, transformed vertices per triangle (0.5 is ideal for a grid, 3 is the worst case) */
+	float acmr() const;
+
+	/* average transform to vertex ratio, transformed vertices per referenced vertex (1 is ideal) */
+	float atvr() const;
+
+	/* adds another mesh's counts, for model wide numbers */
+	void add(const VertexCacheStats& other);
+};
+
+/*
+ * Import time reordering of triangle meshes, nothing here changes what is drawn:
+ * triangles for post-transform cache locality (Forsyth's linear-speed algorithm), then clusters of those
+ * triangles so outward facing parts come first (Sander et al., "Fast Triangle Reordering for Vertex Locality
+ * and Reduced Overdraw"), then vertices in first-use order for fetch locality.
+ */
+class MeshOptimizer
+{
+public:
+	/* FIFO size used for the statistics and the overdraw clusters, a conservative guess for current hardware */
+	static const unsigned int SIMULATED_CACHE_SIZE = 16;
+
+	/* runs all passes below in order */
+	static void optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	/* reorders triangles so recently used vertices are reused while they are still in the cache */
+	static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+	/*
+	 * reorders clusters of triangles (as left by optimizeVertexCache) so outward facing clusters are drawn first.
+	 * a cluster may be split wherever its cache miss ratio stays within threshold times the cluster's own ratio.
+	 */
+	static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+	                             float threshold = 1.05f);
+
+	/* reorders vertices by first use and drops unreferenced ones, rewriting the indices */
+	static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+	                                           unsigned int cacheSize = SIMULATED_CACHE_SIZE);
+};
+
+#endif
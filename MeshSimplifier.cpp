@@ -0,0 +1,543 @@
+#include "MeshSimplifier.h"
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	/* how much a collapse across differing normals or texture coordinates costs, relative to moving the surface */
+	const auto ATTRIBUTE_WEIGHT = 0.5;
+
+	/* weight of the planes that hold open borders in place */
+	const auto BORDER_WEIGHT = 10.0;
+
+	/* what may happen to a vertex: anything, collapse along its border only, or nothing */
+	enum class Vertex_Kind : uint8_t
+	{
+		MANIFOLD,
+		BORDER,
+		LOCKED
+	};
+
+	/* symmetric 4x4 matrix of the squared distance to a set of planes */
+	struct Quadric
+	{
+		double xx = 0.0, xy = 0.0, xz = 0.0, yy = 0.0, yz = 0.0, zz = 0.0;
+
+		double x = 0.0, y = 0.0, z = 0.0, w = 0.0;
+
+		void addPlane(const glm::dvec3& normal, const double distance, const double weight)
+		{
+			xx += weight * normal.x * normal.x;
+
+			xy += weight * normal.x * normal.y;
+
+			xz += weight * normal.x * normal.z;
+
+			yy += weight * normal.y * normal.y;
+
+			yz += weight * normal.y * normal.z;
+
+			zz += weight * normal.z * normal.z;
+
+			x += weight * normal.x * distance;
+
+			y += weight * normal.y * distance;
+
+			z += weight * normal.z * distance;
+
+			w += weight * distance * distance;
+		}
+
+		void add(const Quadric& other)
+		{
+			xx += other.xx;
+
+			xy += other.xy;
+
+			xz += other.xz;
+
+			yy += other.yy;
+
+			yz += other.yz;
+
+			zz += other.zz;
+
+			x += other.x;
+
+			y += other.y;
+
+			z += other.z;
+
+			w += other.w;
+		}
+
+		/* sum of the squared distances of p to the planes */
+		double evaluate(const glm::dvec3& p) const
+		{
+			const auto result = p.x * p.x * xx + p.y * p.y * yy + p.z * p.z * zz +
+				2.0 * (p.x * p.y * xy + p.x * p.z * xz + p.y * p.z * yz) +
+				2.0 * (p.x * x + p.y * y + p.z * z) + w;
+
+			return result > 0.0 ? result : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		/* ordering cost, geometric error plus the attribute penalty */
+		double cost;
+
+		/* geometric part of the cost */
+		double error;
+
+		unsigned int from;
+
+		unsigned int to;
+	};
+
+	uint64_t edgeKey(const unsigned int a, const unsigned int b)
+	{
+		return a < b ? static_cast<uint64_t>(a) << 32 | b : static_cast<uint64_t>(b) << 32 | a;
+	}
+
+	/* vertices at the same position (texture seams, hard edges) share a group, so they share quadrics and edges */
+	std::vector<unsigned int> buildPositionGroups(const std::vector<Vertex>& vertices)
+	{
+		std::vector<unsigned int> order(vertices.size());
+
+		for (auto i = 0u; i < order.size(); ++i)
+		{
+			order[i] = i;
+		}
+
+		const auto less = [&vertices](const unsigned int a, const unsigned int b)
+		{
+			const auto& p = vertices[a].Position;
+
+			const auto& q = vertices[b].Position;
+
+			return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+		};
+
+		std::sort(order.begin(), order.end(), less);
+
+		std::vector<unsigned int> groups(vertices.size());
+
+		for (auto i = 0u; i < order.size(); ++i)
+		{
+			groups[order[i]] = i > 0 && vertices[order[i]].Position == vertices[order[i - 1]].Position
+				                   ? groups[order[i - 1]]
+				                   : order[i];
+		}
+
+		return groups;
+	}
+
+	glm::dvec3 faceNormal(const glm::dvec3& p0, const glm::dvec3& p1, const glm::dvec3& p2)
+	{
+		return glm::cross(p1 - p0, p2 - p0);
+	}
+}
+
+void MeshLodStats::add(const MeshLodStats& other)
+{
+	meshes += other.meshes;
+
+	triangles += other.triangles;
+
+	fullTriangles += other.fullTriangles;
+}
+
+std::vector<unsigned int> MeshSimplifier::simplify(const std::vector<Vertex>& vertices,
+                                                   const std::vector<unsigned int>& indices,
+                                                   const size_t targetIndexCount, const float maxError,
+                                                   float* resultError)
+{
+	auto result = indices;
+
+	auto reachedError = 0.0;
+
+	const auto vertexCount = vertices.size();
+
+	const auto groups = buildPositionGroups(vertices);
+
+	std::vector<glm::dvec3> positions(vertexCount);
+
+	std::vector<unsigned int> groupSizes(vertexCount, 0);
+
+	for (auto i = 0u; i < vertexCount; ++i)
+	{
+		positions[i] = glm::dvec3(vertices[i].Position);
+
+		++groupSizes[groups[i]];
+	}
+
+	/* every edge between position groups and the number of triangles on it, sorted for lookups */
+	std::vector<uint64_t> edges;
+
+	edges.reserve(result.size());
+
+	for (size_t i = 0; i + 2 < result.size(); i += 3)
+	{
+		for (auto e = 0; e < 3; ++e)
+		{
+			edges.push_back(edgeKey(groups[result[i + e]], groups[result[i + (e + 1) % 3]]));
+		}
+	}
+
+	std::sort(edges.begin(), edges.end());
+
+	const auto edgeTriangles = [&edges](const unsigned int a, const unsigned int b)
+	{
+		const auto range = std::equal_range(edges.begin(), edges.end(), edgeKey(a, b));
+
+		return static_cast<size_t>(range.second - range.first);
+	};
+
+	/* seams and non-manifold vertices are locked, vertices on open edges may only slide along them */
+	std::vector<Vertex_Kind> kinds(vertexCount, Vertex_Kind::MANIFOLD);
+
+	std::vector<Quadric> quadrics(vertexCount);
+
+	for (size_t i = 0; i + 2 < result.size(); i += 3)
+	{
+		const auto normal = faceNormal(positions[result[i]], positions[result[i + 1]], positions[result[i + 2]]);
+
+		const auto length = glm::length(normal);
+
+		if (length <= 0.0)
+		{
+			continue;
+		}
+
+		const auto unitNormal = normal / length;
+
+		for (auto e = 0; e < 3; ++e)
+		{
+			const auto a = result[i + e];
+
+			const auto b = result[i + (e + 1) % 3];
+
+			quadrics[groups[a]].addPlane(unitNormal, -glm::dot(unitNormal, positions[a]), 1.0);
+
+			const auto count = edgeTriangles(groups[a], groups[b]);
+
+			if (count == 1)
+			{
+				/* a plane through the border, perpendicular to the triangle */
+				const auto borderNormal = glm::cross(positions[b] - positions[a], unitNormal);
+
+				const auto borderLength = glm::length(borderNormal);
+
+				if (borderLength > 0.0)
+				{
+					const auto unitBorderNormal = borderNormal / borderLength;
+
+					const auto distance = -glm::dot(unitBorderNormal, positions[a]);
+
+					quadrics[groups[a]].addPlane(unitBorderNormal, distance, BORDER_WEIGHT);
+
+					quadrics[groups[b]].addPlane(unitBorderNormal, distance, BORDER_WEIGHT);
+				}
+
+				for (const auto vertex : {a, b})
+				{
+					kinds[vertex] = std::max(kinds[vertex], Vertex_Kind::BORDER);
+				}
+			}
+			else if (count > 2)
+			{
+				kinds[a] = kinds[b] = Vertex_Kind::LOCKED;
+			}
+		}
+	}
+
+	for (auto i = 0u; i < vertexCount; ++i)
+	{
+		if (groupSizes[groups[i]] > 1)
+		{
+			kinds[i] = Vertex_Kind::LOCKED;
+		}
+	}
+
+	const auto maxErrorSquared = static_cast<double>(maxError) * maxError;
+
+	std::vector<unsigned int> adjacencyOffsets(vertexCount + 1);
+
+	std::vector<unsigned int> adjacency;
+
+	std::vector<Collapse> collapses;
+
+	std::vector<unsigned int> remap(vertexCount);
+
+	std::vector<uint8_t> touched(vertexCount);
+
+	/* each pass collapses a set of edges that don't share a neighbourhood, then rewrites the triangles */
+	while (result.size() > targetIndexCount)
+	{
+		/* triangles around each vertex */
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+
+		for (const auto index : result)
+		{
+			++adjacencyOffsets[index + 1];
+		}
+
+		for (auto i = 0u; i < vertexCount; ++i)
+		{
+			adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+		}
+
+		adjacency.resize(result.size());
+
+		for (size_t i = 0; i < result.size(); ++i)
+		{
+			adjacency[adjacencyOffsets[result[i]]++] = static_cast<unsigned int>(i / 3);
+		}
+
+		for (auto i = vertexCount; i > 0; --i)
+		{
+			adjacencyOffsets[i] = adjacencyOffsets[i - 1];
+		}
+
+		adjacencyOffsets[0] = 0;
+
+		/* every allowed collapse along a triangle edge, cheapest first */
+		collapses.clear();
+
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			for (auto e = 0; e < 3; ++e)
+			{
+				const auto from = result[i + e];
+
+				const auto to = result[i + (e + 1) % 3];
+
+				for (const auto& pair : {std::make_pair(from, to), std::make_pair(to, from)})
+				{
+					const auto u = pair.first;
+
+					const auto v = pair.second;
+
+					if (kinds[u] == Vertex_Kind::LOCKED || groups[u] == groups[v])
+					{
+						continue;
+					}
+
+					if (kinds[u] == Vertex_Kind::BORDER &&
+						(kinds[v] == Vertex_Kind::MANIFOLD || edgeTriangles(groups[u], groups[v]) != 1))
+					{
+						continue;
+					}
+
+					auto quadric = quadrics[groups[u]];
+
+					quadric.add(quadrics[groups[v]]);
+
+					const auto error = quadric.evaluate(positions[v]);
+
+					const auto edgeLength = glm::length(positions[v] - positions[u]);
+
+					const auto normalDelta = glm::length(vertices[u].Normal - vertices[v].Normal);
+
+					const auto texCoordDelta = glm::length(vertices[u].TexCoords - vertices[v].TexCoords);
+
+					const auto attributeError = ATTRIBUTE_WEIGHT * edgeLength * edgeLength *
+						(normalDelta * normalDelta + texCoordDelta * texCoordDelta);
+
+					collapses.push_back(Collapse{error + attributeError, error, u, v});
+				}
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(),
+		          [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+		for (auto i = 0u; i < vertexCount; ++i)
+		{
+			remap[i] = i;
+		}
+
+		std::fill(touched.begin(), touched.end(), 0);
+
+		/* each collapse removes about two triangles, leave the rest for later passes so costs stay current */
+		const auto collapseLimit = std::max<size_t>(1, (result.size() - targetIndexCount) / 6);
+
+		size_t collapsed = 0;
+
+		for (const auto& collapse : collapses)
+		{
+			if (collapsed >= collapseLimit || collapse.error > maxErrorSquared)
+			{
+				break;
+			}
+
+			const auto u = collapse.from;
+
+			const auto v = collapse.to;
+
+			if (touched[u] != 0 || touched[v] != 0)
+			{
+				continue;
+			}
+
+			/* moving u onto v must not fold any of u's remaining triangles over */
+			auto flips = false;
+
+			for (auto t = adjacencyOffsets[u]; t < adjacencyOffsets[u + 1] && !flips; ++t)
+			{
+				const auto triangle = &result[adjacency[t] * 3];
+
+				if (triangle[0] == v || triangle[1] == v || triangle[2] == v)
+				{
+					continue;
+				}
+
+				glm::dvec3 corners[3];
+
+				for (auto c = 0; c < 3; ++c)
+				{
+					corners[c] = positions[triangle[c]];
+				}
+
+				const auto before = faceNormal(corners[0], corners[1], corners[2]);
+
+				for (auto& corner : corners)
+				{
+					if (corner == positions[u])
+					{
+						corner = positions[v];
+					}
+				}
+
+				flips = glm::dot(before, faceNormal(corners[0], corners[1], corners[2])) <= 0.0;
+			}
+
+			if (flips)
+			{
+				continue;
+			}
+
+			remap[u] = v;
+
+			quadrics[groups[v]].add(quadrics[groups[u]]);
+
+			reachedError = std::max(reachedError, collapse.error);
+
+			/* the neighbourhood of u changed shape, its vertices wait for the next pass */
+			for (auto t = adjacencyOffsets[u]; t < adjacencyOffsets[u + 1]; ++t)
+			{
+				for (auto c = 0; c < 3; ++c)
+				{
+					touched[result[adjacency[t] * 3 + c]] = 1;
+				}
+			}
+
+			touched[v] = 1;
+
+			++collapsed;
+		}
+
+		if (collapsed == 0)
+		{
+			break;
+		}
+
+		/* rewrite the triangles and drop those that collapsed */
+		size_t write = 0;
+
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			const auto a = remap[result[i]];
+
+			const auto b = remap[result[i + 1]];
+
+			const auto c = remap[result[i + 2]];
+
+			if (a != b && b != c && a != c)
+			{
+				result[write++] = a;
+
+				result[write++] = b;
+
+				result[write++] = c;
+			}
+		}
+
+		result.resize(write);
+	}
+
+	if (resultError != nullptr)
+	{
+		*resultError = static_cast<float>(std::sqrt(reachedError));
+	}
+
+	return result;
+}
+
+std::vector<MeshLod> MeshSimplifier::buildLodChain(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                                                   const float maxRelativeError)
+{
+	std::vector<MeshLod> lods;
+
+	lods.push_back(MeshLod{0, static_cast<uint32_t>(indices.size()), 0.f});
+
+	if (vertices.empty())
+	{
+		return lods;
+	}
+
+	auto minimum = vertices[0].Position;
+
+	auto maximum = minimum;
+
+	for (const auto& vertex : vertices)
+	{
+		minimum = glm::min(minimum, vertex.Position);
+
+		maximum = glm::max(maximum, vertex.Position);
+	}
+
+	const auto maxError = maxRelativeError * 0.5f * glm::length(maximum - minimum);
+
+	/* every level is simplified from the full mesh, so its error is measured against the original surface */
+	const auto full = indices;
+
+	auto previousCount = full.size();
+
+	auto previousError = 0.f;
+
+	while (lods.size() < MAX_LODS)
+	{
+		const auto targetCount = previousCount / 6 * 3;
+
+		if (targetCount < MIN_LOD_TRIANGLES * 3)
+		{
+			break;
+		}
+
+		auto error = 0.f;
+
+		auto lod = simplify(vertices, full, targetCount, maxError, &error);
+
+		if (lod.empty() || lod.size() * 10 > previousCount * 9)
+		{
+			break;
+		}
+
+		MeshOptimizer::optimizeVertexCache(lod, vertices.size());
+
+		/* coarser levels never claim to be more accurate than finer ones */
+		previousError = std::max(previousError, error);
+
+		lods.push_back(MeshLod{static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.size()), previousError});
+
+		indices.insert(indices.end(), lod.begin(), lod.end());
+
+		previousCount = lod.size();
+	}
+
+	return lods;
+}
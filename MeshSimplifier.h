@@ -0,0 +1,67 @@
+#pragma once
+
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Vertex;
+
+/* one level of detail of a mesh: a range of its index buffer and how far it strays from the full mesh */
+struct MeshLod
+{
+	uint32_t indexOffset;
+
+	uint32_t indexCount;
+
+	/* largest distance (in model units) the simplified surface may be from the original, 0 for the full mesh */
+	float error;
+};
+
+/* triangles drawn by a level of detail draw, and what the full meshes would have cost */
+struct MeshLodStats
+{
+	size_t meshes = 0;
+
+	size_t triangles = 0;
+
+	size_t fullTriangles = 0;
+
+	/* adds another mesh's counts, for frame totals */
+	void add(const MeshLodStats& other);
+};
+
+/*
+ * Import time simplification with quadric error metrics (Garland and Heckbert, "Surface Simplification Using
+ * Quadric Error Metrics"). Edges collapse into one of their own vertices, so every level of detail indexes the
+ * vertices of the full mesh and keeps their attributes. Collapses that smear normals or texture coordinates are
+ * made more expensive, vertices on texture seams don't move and open borders only shrink along themselves.
+ */
+class MeshSimplifier
+{
+public:
+	/* levels in a chain, the full mesh included */
+	static const unsigned int MAX_LODS = 5;
+
+	/* a chain ends at a level this small, or once a level removes less than a tenth of its predecessor */
+	static const unsigned int MIN_LOD_TRIANGLES = 32;
+
+	/*
+	 * collapses edges until at most targetIndexCount indices are left or the next collapse would cost more than maxError
+	 * (in model units). returns the simplified index buffer, the error it reached is stored in resultError.
+	 */
+	static std::vector<unsigned int> simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+	                                          size_t targetIndexCount, float maxError, float* resultError = nullptr);
+
+	/*
+	 * appends successively halved levels of detail to indices, behind the full mesh (level 0), each ordered for the
+	 * vertex cache. maxRelativeError limits the error of the coarsest level relative to the mesh's bounding radius.
+	 * returns the ranges of all levels, the full mesh first.
+	 */
+	static std::vector<MeshLod> buildLodChain(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+	                                          float maxRelativeError = 0.1f);
+};
+
+#endif
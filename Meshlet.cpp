@@ -0,0 +1,377 @@
+#include "Meshlet.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <future>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MESHLET_CULL_SSE 1
+#endif
+
+void MeshletCullStats::add(const MeshletCullStats& other)
+{
+	meshlets += other.meshlets;
+
+	visible += other.visible;
+
+	frustumCulled += other.frustumCulled;
+
+	backfaceCulled += other.backfaceCulled;
+}
+
+std::vector<Meshlet> Meshlets::build(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+{
+	std::vector<Meshlet> meshlets;
+
+	/* meshlet that last took each vertex, so membership is a single compare */
+	std::vector<uint32_t> owner(vertices.size(), UINT32_MAX);
+
+	std::vector<unsigned int> local;
+
+	local.reserve(MAX_VERTICES);
+
+	std::vector<glm::vec3> normals;
+
+	normals.reserve(MAX_TRIANGLES);
+
+	Meshlet current = {};
+
+	const auto finish = [&]()
+	{
+		/* bounding sphere around the centre of the box */
+		auto minimum = vertices[local[0]].Position;
+
+		auto maximum = minimum;
+
+		for (const auto vertex : local)
+		{
+			minimum = glm::min(minimum, vertices[vertex].Position);
+
+			maximum = glm::max(maximum, vertices[vertex].Position);
+		}
+
+		current.center = (minimum + maximum) * 0.5f;
+
+		current.radius = 0.f;
+
+		for (const auto vertex : local)
+		{
+			current.radius = std::max(current.radius, glm::length(vertices[vertex].Position - current.center));
+		}
+
+		current.vertexCount = static_cast<uint32_t>(local.size());
+
+		/* normal cone around the average face normal, degenerate triangles don't count */
+		normals.clear();
+
+		auto sum = glm::vec3(0.f);
+
+		for (auto t = 0u; t < current.triangleCount; ++t)
+		{
+			const auto index = current.indexOffset + t * 3;
+
+			const auto& p0 = vertices[indices[index]].Position;
+
+			const auto normal = glm::cross(vertices[indices[index + 1]].Position - p0,
+			                               vertices[indices[index + 2]].Position - p0);
+
+			const auto length = glm::length(normal);
+
+			if (length > 0.f)
+			{
+				normals.push_back(normal / length);
+
+				sum += normals.back();
+			}
+		}
+
+		current.coneAxis = glm::vec3(0.f, 0.f, 1.f);
+
+		current.coneCutoff = 1.f;
+
+		const auto sumLength = glm::length(sum);
+
+		if (sumLength > 1e-6f)
+		{
+			const auto axis = sum / sumLength;
+
+			auto minimumDot = 1.f;
+
+			for (const auto& normal : normals)
+			{
+				minimumDot = std::min(minimumDot, glm::dot(axis, normal));
+			}
+
+			/* cones wider than ~84 degrees are visible from nearly everywhere, don't bother testing them */
+			if (minimumDot > 0.1f)
+			{
+				current.coneAxis = axis;
+
+				current.coneCutoff = std::sqrt(1.f - minimumDot * minimumDot);
+			}
+		}
+
+		meshlets.push_back(current);
+
+		current.indexOffset += current.triangleCount * 3;
+
+		current.triangleCount = 0;
+
+		local.clear();
+	};
+
+	for (size_t index = 0; index + 2 < indices.size(); index += 3)
+	{
+		const auto id = static_cast<uint32_t>(meshlets.size());
+
+		const auto a = indices[index];
+
+		const auto b = indices[index + 1];
+
+		const auto c = indices[index + 2];
+
+		const auto added = (owner[a] != id) + (b != a && owner[b] != id) + (c != a && c != b && owner[c] != id);
+
+		if (local.size() + added > MAX_VERTICES || current.triangleCount == MAX_TRIANGLES)
+		{
+			finish();
+		}
+
+		for (const auto vertex : {a, b, c})
+		{
+			if (owner[vertex] != static_cast<uint32_t>(meshlets.size()))
+			{
+				owner[vertex] = static_cast<uint32_t>(meshlets.size());
+
+				local.push_back(vertex);
+			}
+		}
+
+		++current.triangleCount;
+	}
+
+	if (current.triangleCount > 0)
+	{
+		finish();
+	}
+
+	return meshlets;
+}
+
+MeshletBounds Meshlets::packBounds(const std::vector<Meshlet>& meshlets)
+{
+	MeshletBounds bounds;
+
+	bounds.count = meshlets.size();
+
+	const auto padded = (meshlets.size() + 3) & ~static_cast<size_t>(3);
+
+	/* padding has a sphere no plane can contain, so it is never visible */
+	for (auto array : {&bounds.centerX, &bounds.centerY, &bounds.centerZ, &bounds.coneX, &bounds.coneY, &bounds.coneZ})
+	{
+		array->assign(padded, 0.f);
+	}
+
+	bounds.radius.assign(padded, -FLT_MAX);
+
+	bounds.coneCutoff.assign(padded, 1.f);
+
+	for (auto i = 0u; i < meshlets.size(); ++i)
+	{
+		const auto& meshlet = meshlets[i];
+
+		bounds.centerX[i] = meshlet.center.x;
+
+		bounds.centerY[i] = meshlet.center.y;
+
+		bounds.centerZ[i] = meshlet.center.z;
+
+		bounds.radius[i] = meshlet.radius;
+
+		bounds.coneX[i] = meshlet.coneAxis.x;
+
+		bounds.coneY[i] = meshlet.coneAxis.y;
+
+		bounds.coneZ[i] = meshlet.coneAxis.z;
+
+		bounds.coneCutoff[i] = meshlet.coneCutoff;
+	}
+
+	return bounds;
+}
+
+MeshletCullStats Meshlets::cull(const MeshletBounds& bounds, const glm::mat4& modelViewProjection,
+                                const glm::vec3& viewerPosition, std::vector<uint8_t>& visible)
+{
+	/* frustum planes in model space (Gribb/Hartmann), normalized so distances compare with the radius */
+	const auto& m = modelViewProjection;
+
+	const auto row = [&m](const int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+
+	glm::vec4 planes[6] = {
+		row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(3) + row(2), row(3) - row(2)
+	};
+
+	for (auto& plane : planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	const auto padded = bounds.radius.size();
+
+	visible.resize(padded);
+
+	MeshletCullStats stats;
+
+	if (padded <= PARALLEL_THRESHOLD)
+	{
+		cullRange(bounds, planes, viewerPosition, 0, padded, visible.data(), stats);
+
+		return stats;
+	}
+
+	/* one chunk per worker plus one for this thread, in multiples of 4 */
+	auto& pool = ThreadPool::shared();
+
+	const auto chunks = static_cast<size_t>(pool.size()) + 1;
+
+	const auto chunkSize = ((padded + chunks - 1) / chunks + 3) & ~static_cast<size_t>(3);
+
+	std::vector<std::future<MeshletCullStats>> futures;
+
+	for (auto first = chunkSize; first < padded; first += chunkSize)
+	{
+		const auto last = std::min(first + chunkSize, padded);
+
+		const auto output = visible.data();
+
+		futures.push_back(pool.submit([&bounds, &planes, viewerPosition, first, last, output]()
+		{
+			MeshletCullStats chunkStats;
+
+			cullRange(bounds, planes, viewerPosition, first, last, output, chunkStats);
+
+			return chunkStats;
+		}));
+	}
+
+	cullRange(bounds, planes, viewerPosition, 0, std::min(chunkSize, padded), visible.data(), stats);
+
+	for (auto& future : futures)
+	{
+		stats.add(future.get());
+	}
+
+	return stats;
+}
+
+void Meshlets::cullRange(const MeshletBounds& bounds, const glm::vec4* planes, const glm::vec3& viewerPosition,
+                         const size_t first, const size_t last, uint8_t* visible, MeshletCullStats& stats)
+{
+	for (auto i = first; i < last; i += 4)
+	{
+		int insideMask = 0;
+
+		int backMask = 0;
+
+#ifdef MESHLET_CULL_SSE
+		const auto centerX = _mm_loadu_ps(&bounds.centerX[i]);
+
+		const auto centerY = _mm_loadu_ps(&bounds.centerY[i]);
+
+		const auto centerZ = _mm_loadu_ps(&bounds.centerZ[i]);
+
+		const auto radius = _mm_loadu_ps(&bounds.radius[i]);
+
+		const auto negativeRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+		auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+		for (auto p = 0; p < 6; ++p)
+		{
+			const auto distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(planes[p].x)), _mm_mul_ps(centerY, _mm_set1_ps(planes[p].y))),
+				_mm_add_ps(_mm_mul_ps(centerZ, _mm_set1_ps(planes[p].z)), _mm_set1_ps(planes[p].w)));
+
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+		}
+
+		const auto toCenterX = _mm_sub_ps(centerX, _mm_set1_ps(viewerPosition.x));
+
+		const auto toCenterY = _mm_sub_ps(centerY, _mm_set1_ps(viewerPosition.y));
+
+		const auto toCenterZ = _mm_sub_ps(centerZ, _mm_set1_ps(viewerPosition.z));
+
+		const auto distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(toCenterX, toCenterX),
+		                                                        _mm_mul_ps(toCenterY, toCenterY)),
+		                                             _mm_mul_ps(toCenterZ, toCenterZ)));
+
+		const auto along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toCenterX, _mm_loadu_ps(&bounds.coneX[i])),
+		                                         _mm_mul_ps(toCenterY, _mm_loadu_ps(&bounds.coneY[i]))),
+		                              _mm_mul_ps(toCenterZ, _mm_loadu_ps(&bounds.coneZ[i])));
+
+		const auto back = _mm_cmpge_ps(along, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&bounds.coneCutoff[i]), distance),
+		                                                 radius));
+
+		insideMask = _mm_movemask_ps(inside);
+
+		backMask = _mm_movemask_ps(back);
+#else
+		for (auto lane = 0; lane < 4; ++lane)
+		{
+			const auto center = glm::vec3(bounds.centerX[i + lane], bounds.centerY[i + lane], bounds.centerZ[i + lane]);
+
+			const auto radius = bounds.radius[i + lane];
+
+			auto inside = true;
+
+			for (auto p = 0; p < 6; ++p)
+			{
+				inside = inside && glm::dot(glm::vec3(planes[p]), center) + planes[p].w >= -radius;
+			}
+
+			const auto toCenter = center - viewerPosition;
+
+			const auto axis = glm::vec3(bounds.coneX[i + lane], bounds.coneY[i + lane], bounds.coneZ[i + lane]);
+
+			const auto back = glm::dot(toCenter, axis) >= bounds.coneCutoff[i + lane] * glm::length(toCenter) + radius;
+
+			insideMask |= inside ? 1 << lane : 0;
+
+			backMask |= back ? 1 << lane : 0;
+		}
+#endif
+
+		for (auto lane = 0; lane < 4; ++lane)
+		{
+			const auto inside = (insideMask >> lane & 1) != 0;
+
+			const auto back = (backMask >> lane & 1) != 0;
+
+			visible[i + lane] = inside && !back;
+
+			if (i + lane >= bounds.count)
+			{
+				continue;
+			}
+
+			++stats.meshlets;
+
+			if (!inside)
+			{
+				++stats.frustumCulled;
+			}
+			else if (back)
+			{
+				++stats.backfaceCulled;
+			}
+			else
+			{
+				++stats.visible;
+			}
+		}
+	}
+}
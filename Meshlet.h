@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Vertex;
+
+/*
+ * A run of consecutive triangles of a mesh's index buffer with few enough distinct vertices to be culled as a unit.
+ * Bounds are in model space.
+ */
+struct Meshlet
+{
+	/* first index and number of triangles in the mesh's index buffer */
+	uint32_t indexOffset;
+
+	uint32_t triangleCount;
+
+	uint32_t vertexCount;
+
+	glm::vec3 center;
+
+	float radius;
+
+	/*
+	 * normal cone: every triangle faces away from a viewer for which
+	 * dot(center - viewer, coneAxis) >= coneCutoff * length(center - viewer) + radius. coneCutoff is 1 if never.
+	 */
+	glm::vec3 coneAxis;
+
+	float coneCutoff;
+};
+
+/* the bounds of a mesh's meshlets as a structure of arrays, padded with never visible entries to a multiple of 4 */
+struct MeshletBounds
+{
+	std::vector<float> centerX, centerY, centerZ, radius;
+
+	std::vector<float> coneX, coneY, coneZ, coneCutoff;
+
+	size_t count = 0;
+};
+
+/* outcome of culling one mesh */
+struct MeshletCullStats
+{
+	size_t meshlets = 0;
+
+	size_t visible = 0;
+
+	size_t frustumCulled = 0;
+
+	size_t backfaceCulled = 0;
+
+	/* adds another mesh's counts, for frame totals */
+	void add(const MeshletCullStats& other);
+};
+
+/*
+ * Splits meshes into meshlets at import and culls them every frame: a sphere against the view frustum and the
+ * normal cone against the viewer, four meshlets at a time with SSE (scalar elsewhere).
+ * Large meshes are split over the shared thread pool.
+ */
+class Meshlets
+{
+public:
+	static const unsigned int MAX_VERTICES = 64;
+
+	static const unsigned int MAX_TRIANGLES = 124;
+
+	/* meshes with more meshlets than this are culled in parallel */
+	static const size_t PARALLEL_THRESHOLD = 4096;
+
+	/* greedy split in index order, run it after MeshOptimizer so the runs are spatially compact */
+	static std::vector<Meshlet> build(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+
+	static MeshletBounds packBounds(const std::vector<Meshlet>& meshlets);
+
+	/*
+	 * sets visible[i] to 1 for every meshlet that is inside the frustum and faces the viewer, 0 otherwise.
+	 * modelViewProjection and viewerPosition are relative to the mesh's model space (rigid or uniformly scaled transforms).
+	 */
+	static MeshletCullStats cull(const MeshletBounds& bounds, const glm::mat4& modelViewProjection,
+	                             const glm::vec3& viewerPosition, std::vector<uint8_t>& visible);
+
+private:
+	/* culls meshlets [first, last), first and last are multiples of 4 */
+	static void cullRange(const MeshletBounds& bounds, const glm::vec4* planes, const glm::vec3& viewerPosition,
+	                      size_t first, size_t last, uint8_t* visible, MeshletCullStats& stats);
+};
+
+#endif
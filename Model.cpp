@@ -1,84 +1,154 @@
 #include "Model.h"
+#include "GeometryArena.h"
+#include "GLStateCache.h"
 #include "Mesh.h"
+#include "ModelCooker.h"
 #include "Shader.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <cstddef>
+#include <cstring>
+#include <future>
 #include <iostream>
-#include <stb_image.h>
+#include <utility>
 
-unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false)
+Model::Model(const std::string& path, const bool gamma, const ModelLoadOptions& options) : gammaCorrection(gamma),
+	options(options)
 {
-	auto filename = std::string(path);
+	loadModel(path);
 
-	filename = directory + '/' + filename;
+	if (options.reportMeshStats)
+	{
+		std::cout << "MESH_OPTIMIZER::" << path << ": " << cacheStatsBefore.triangleCount << " triangles, ACMR " <<
+			cacheStatsBefore.acmr() << " -> " << cacheStatsAfter.acmr() << ", ATVR " << cacheStatsBefore.atvr() <<
+			" -> " << cacheStatsAfter.atvr() << std::endl;
 
-	unsigned int textureID;
+		MeshMemoryStats memory;
 
-	glGenTextures(1, &textureID);
+		for (const auto& mesh : meshes)
+		{
+			memory.add(mesh.getMemoryStats());
+		}
 
-	int width, height, nrComponents;
+		std::cout << "MESH_MEMORY::" << path << ": vertices " << memory.vertexBytes / 1024 << " KB (saved " <<
+			memory.vertexBytesSaved / 1024 << " KB), indices " << memory.indexBytes / 1024 << " KB (saved " <<
+			memory.indexBytesSaved / 1024 << " KB)" << std::endl;
 
-	const auto data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
+		if (options.generateLods)
+		{
+			/* triangles of each level over all meshes, meshes with a shorter chain count their coarsest level */
+			std::cout << "MESH_LOD::" << path << ":";
 
-	if (data != nullptr)
-	{
-		GLenum format;
+			for (auto level = 0u; level < MeshSimplifier::MAX_LODS; ++level)
+			{
+				size_t triangles = 0;
 
-		if (nrComponents == 1)
-		{
-			format = GL_RED;
-		}
-		else if (nrComponents == 3)
-		{
-			format = GL_RGB;
-		}
-		else if (nrComponents == 4)
-		{
-			format = GL_RGBA;
-		}
+				for (const auto& mesh : meshes)
+				{
+					const auto& lods = mesh.getLods();
 
-		glBindTexture(GL_TEXTURE_2D, textureID);
+					triangles += lods[std::min<size_t>(level, lods.size() - 1)].indexCount / 3;
+				}
 
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+				std::cout << (level > 0 ? " -> " : " ") << triangles;
+			}
 
-		glGenerateMipmap(GL_TEXTURE_2D);
+			std::cout << " triangles" << std::endl;
+		}
+	}
+}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+Model::~Model()
+{
+	if (meshes.empty())
+	{
+		return;
+	}
+
+	/* the meshes return their arena space as they go, then the holes they left are closed */
+	meshes.clear();
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	GeometryArena::compact();
+}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+void Model::Draw(const Shader& shader) const
+{
+	if (DrawBatch::isBatchedShader(shader))
+	{
+		if (batch == nullptr)
+		{
+			batch.reset(new DrawBatch());
+		}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		batch->draw(shader, meshes);
 
-		stbi_image_free(data);
+		return;
 	}
-	else
-	{
-		std::cout << "Texture failed to load at path: " << path << std::endl;
 
-		stbi_image_free(data);
+	for (const auto& mesh : meshes)
+	{
+		mesh.Draw(shader);
 	}
+}
 
-	return textureID;
+void Model::DrawInstanced(const Shader& shader, const unsigned int instanceCount) const
+{
+	for (const auto& mesh : meshes)
+	{
+		mesh.DrawInstanced(shader, instanceCount);
+	}
 }
 
-Model::Model(const std::string& path, const bool gamma) : gammaCorrection(gamma)
+MeshletCullStats Model::DrawCulled(const Shader& shader, const glm::mat4& model, const glm::mat4& viewProjection,
+                                   const glm::vec3& viewPosition) const
 {
-	loadModel(path);
+	MeshletCullStats stats;
+
+	for (const auto& mesh : meshes)
+	{
+		stats.add(mesh.drawCulled(shader, model, viewProjection, viewPosition));
+	}
+
+	return stats;
 }
 
-void Model::Draw(const Shader& shader) const
+MeshLodStats Model::DrawLod(const Shader& shader, const glm::mat4& model, const Camera& camera,
+                            const float viewportHeight, const float errorPixels) const
 {
+	MeshLodStats stats;
+
 	for (const auto& mesh : meshes)
 	{
-		mesh.Draw(shader);
+		const auto lod = mesh.selectLod(model, camera, viewportHeight, errorPixels);
+
+		mesh.drawLod(shader, lod);
+
+		++stats.meshes;
+
+		stats.triangles += mesh.getLods()[lod].indexCount / 3;
+
+		stats.fullTriangles += mesh.getIndexCount() / 3;
 	}
+
+	return stats;
 }
 
 void Model::loadModel(const std::string& path)
 {
+	/* a cooked file that is current for the source and options skips the import */
+	if (options.useCookedModel && ModelCooker::load(path, options, *this))
+	{
+		if (options.reportMeshStats)
+		{
+			std::cout << "MODEL_COOKER::" << path << ": loaded " << ModelCooker::cookedPath(path) << std::endl;
+		}
+
+		return;
+	}
+
 	/* read file via ASSIMP */
 	Assimp::Importer importer;
 
@@ -94,129 +164,180 @@ void Model::loadModel(const std::string& path)
 	/* retrieve the directory path of the filepath */
 	directory = path.substr(0, path.find_last_of('/'));
 
-	/* process ASSIMP's root node recursively */
-	processNode(scene->mRootNode, scene);
+	/* gather the meshes of ASSIMP's node tree, in the order they end up in meshes */
+	std::vector<const aiMesh*> sceneMeshes;
+
+	processNode(scene->mRootNode, scene, sceneMeshes);
+
+	/* conversion, reordering, levels of detail and meshlets only need the CPU: one task per mesh */
+	std::vector<std::future<ImportedMesh>> imports;
+
+	imports.reserve(sceneMeshes.size());
+
+	const auto importOptions = options;
+
+	for (const auto mesh : sceneMeshes)
+	{
+		imports.push_back(ThreadPool::shared().submit([mesh, importOptions]() { return importMesh(mesh, importOptions); }));
+	}
+
+	/* textures and uploads need the GL thread, done in order while later meshes are still being imported */
+	meshes.reserve(sceneMeshes.size());
+
+	try
+	{
+		for (auto i = 0u; i < sceneMeshes.size(); ++i)
+		{
+			meshes.push_back(processMesh(imports[i].get(), sceneMeshes[i], scene));
+		}
+	}
+	catch (...)
+	{
+		/* the tasks read the scene, which goes away with the importer */
+		for (auto& import : imports)
+		{
+			if (import.valid())
+			{
+				import.wait();
+			}
+		}
+
+		throw;
+	}
+
+	if (options.useCookedModel)
+	{
+		ModelCooker::store(path, options, *this);
+	}
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+void Model::processNode(aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& sceneMeshes)
 {
-	/* process each mesh located at the current node */
+	/* collect each mesh located at the current node */
 	for (auto i = 0u; i < node->mNumMeshes; ++i)
 	{
 		/*
 		 * the node object only contains indices to index the actual objects in the scene.
 		 * the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
 		 */
-		const auto mesh = scene->mMeshes[node->mMeshes[i]];
-
-		meshes.push_back(processMesh(mesh, scene));
+		sceneMeshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 	}
 
-	/* after we've processed all of the meshes (if any) we then recursively process each of the children nodes */
+	/* after we've collected all of the meshes (if any) we then recursively process each of the children nodes */
 	for (auto i = 0u; i < node->mNumChildren; ++i)
 	{
-		processNode(node->mChildren[i], scene);
+		processNode(node->mChildren[i], scene, sceneMeshes);
 	}
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+Model::ImportedMesh Model::importMesh(const aiMesh* mesh, const ModelLoadOptions& options)
 {
-	/* data to fill */
-	std::vector<Vertex> vertices;
-
-	std::vector<unsigned int> indices;
-
-	std::vector<Texture> textures;
-
-	/* Walk through each of the mesh's vertices */
-	for (auto i = 0u; i < mesh->mNumVertices; ++i)
-	{
-		Vertex vertex;
-
-		/*
-		 * we declare a placeholder vector since assimp uses its own vector class
-		 * that doesn't directly convert to glm's vec3 class
-		 * so we transfer the data to this placeholder glm::vec3 first.
-		 */
-		glm::vec3 vector;
-
-		/* positions */
-		vector.x = mesh->mVertices[i].x;
+	static_assert(sizeof(aiVector3D) == sizeof(glm::vec3), "assimp vectors are copied as glm vectors");
 
-		vector.y = mesh->mVertices[i].y;
+	ImportedMesh result;
 
-		vector.z = mesh->mVertices[i].z;
+	/* data to fill, sized up front and written in place */
+	auto& vertices = result.vertices;
 
-		vertex.Position = vector;
+	auto& indices = result.indices;
 
-		/* normals */
-		vector.x = mesh->mNormals[i].x;
+	vertices.resize(mesh->mNumVertices);
 
-		vector.y = mesh->mNormals[i].y;
+	/*
+	 * assimp keeps each attribute in its own array of 3 floats, the same layout as glm::vec3,
+	 * so whole vectors are copied instead of converting component by component.
+	 * attributes a mesh doesn't have stay zero (no normals, or no tangents without texture coordinates)
+	 */
+	const aiVector3D* sources[] = {mesh->mVertices, mesh->mNormals, mesh->mTangents, mesh->mBitangents};
 
-		vector.z = mesh->mNormals[i].z;
+	const size_t targets[] = {
+		offsetof(Vertex, Position), offsetof(Vertex, Normal), offsetof(Vertex, Tangent), offsetof(Vertex, Bitangent)
+	};
 
-		vertex.Normal = vector;
+	for (auto attribute = 0; attribute < 4; ++attribute)
+	{
+		const auto source = sources[attribute];
 
-		/* texture coordinates */
-		/* does the mesh contain texture coordinates? */
-		if (mesh->mTextureCoords[0] != nullptr)
+		if (source == nullptr)
 		{
-			glm::vec2 vec;
-
-			/*
-			 * a vertex can contain up to 8 different texture coordinates.
-			 * We thus make the assumption that we won't
-			 * use models where a vertex can have multiple texture coordinates
-			 * so we always take the first set (0).
-			 */
-			vec.x = mesh->mTextureCoords[0][i].x;
+			continue;
+		}
 
-			vec.y = mesh->mTextureCoords[0][i].y;
+		const auto target = reinterpret_cast<char*>(vertices.data()) + targets[attribute];
 
-			vertex.TexCoords = vec;
-		}
-		else
+		for (auto i = 0u; i < mesh->mNumVertices; ++i)
 		{
-			vertex.TexCoords = glm::vec2(0.f, 0.f);
+			std::memcpy(target + i * sizeof(Vertex), &source[i], sizeof(glm::vec3));
 		}
+	}
 
-		/* tangent */
-		vector.x = mesh->mTangents[i].x;
-
-		vector.y = mesh->mTangents[i].y;
-
-		vector.z = mesh->mTangents[i].z;
-
-		vertex.Tangent = vector;
-
-		/* bitangent */
-		vector.x = mesh->mBitangents[i].x;
-
-		vector.y = mesh->mBitangents[i].y;
-
-		vector.z = mesh->mBitangents[i].z;
-
-		vertex.Bitangent = vector;
-
-		vertices.push_back(vertex);
+	/*
+	 * a vertex can contain up to 8 different texture coordinates.
+	 * We thus make the assumption that we won't
+	 * use models where a vertex can have multiple texture coordinates
+	 * so we always take the first set (0).
+	 */
+	if (mesh->mTextureCoords[0] != nullptr)
+	{
+		for (auto i = 0u; i < mesh->mNumVertices; ++i)
+		{
+			vertices[i].TexCoords = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+		}
 	}
 
 	/*
-	* now wak through each of the mesh's faces (a face is a mesh its triangle)
+	* now walk through each of the mesh's faces (a face is a mesh its triangle)
 	* and retrieve the corresponding vertex indices.
 	*/
+	indices.reserve(mesh->mNumFaces * 3);
+
 	for (auto i = 0u; i < mesh->mNumFaces; ++i)
 	{
-		auto face = mesh->mFaces[i];
+		const auto& face = mesh->mFaces[i];
 
 		/* retrieve all indices of the face and store them in the indices vector */
-		for (auto j = 0u; j < face.mNumIndices; ++j)
+		indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+	}
+
+	/* optional: reorder for the post-transform cache, overdraw and vertex fetch */
+	if (options.optimizeMeshes || options.reportMeshStats)
+	{
+		result.cacheStatsBefore = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+
+		if (options.optimizeMeshes)
 		{
-			indices.push_back(face.mIndices[j]);
+			MeshOptimizer::optimize(vertices, indices);
 		}
+
+		result.cacheStatsAfter = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+	}
+
+	/*
+	 * optional: clusters for meshlet culling, after the reordering so they are compact and before the levels of
+	 * detail are appended, meshlets only ever cover the full mesh
+	 */
+	if (options.buildMeshlets)
+	{
+		result.meshlets = Meshlets::build(vertices, indices);
+	}
+
+	/* optional: simplified levels of detail behind the full index buffer, they index the final vertex order */
+	if (options.generateLods)
+	{
+		result.lods = MeshSimplifier::buildLodChain(vertices, indices);
 	}
 
+	return result;
+}
+
+Mesh Model::processMesh(ImportedMesh imported, const aiMesh* mesh, const aiScene* scene)
+{
+	std::vector<Texture> textures;
+
+	cacheStatsBefore.add(imported.cacheStatsBefore);
+
+	cacheStatsAfter.add(imported.cacheStatsAfter);
+
 	/* process materials */
 	auto material = scene->mMaterials[mesh->mMaterialIndex];
 
@@ -229,35 +350,44 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
 	 * normal: texture_normalN
 	 */
 	/* 1. diffuse maps */
-	auto diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
+	auto diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, Texture_Type::DIFFUSE);
 
 	textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
 
 	/* 2. specular maps */
-	auto specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
+	auto specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, Texture_Type::SPECULAR);
 
 	textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 
 	/* 3. normal maps */
-	auto normalMaps = loadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal");
+	auto normalMaps = loadMaterialTextures(material, aiTextureType_HEIGHT, Texture_Type::NORMAL);
 
 	textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
 
 	/* 4. height maps */
-	auto heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
+	auto heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, Texture_Type::HEIGHT);
 
 	textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
 	/* 5. reflection maps */
-	auto reflectionMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_reflection");
+	auto reflectionMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, Texture_Type::REFLECTION);
 
 	textures.insert(textures.end(), reflectionMaps.begin(), reflectionMaps.end());
 
-	/* return a mesh object created from the extracted mesh data */
-	return Mesh(vertices, indices, textures);
+	/* return a mesh object created from the extracted mesh data, it takes the vectors over */
+	Mesh result(std::move(imported.vertices), std::move(imported.indices), std::move(textures),
+	            std::move(imported.lods), std::move(imported.meshlets));
+
+	/* optional: everything that needs the CPU copy is done, only the GPU copy is drawn */
+	if (options.releaseCpuGeometry)
+	{
+		result.releaseCpuGeometry();
+	}
+
+	return result;
 }
 
-std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, const aiTextureType type, const std::string& typeName)
+std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, const aiTextureType type, const Texture_Type textureType)
 {
 	std::vector<Texture> textures;
 
@@ -267,48 +397,36 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, const aiTextur
 
 		mat->GetTexture(type, i, &str);
 
-		/*
-		 * check if texture was loaded before and if so,
-		 * continue to next iteration: skip loading a new texture
-		 */
-		auto skip = false;
+		textures.push_back(loadTexture(str.C_Str(), textureType));
+	}
 
-		for (auto& texture_loaded : textures_loaded)
-		{
-			if (std::strcmp(texture_loaded.path.data(), str.C_Str()) == 0)
-			{
-				textures.push_back(texture_loaded);
+	return textures;
+}
 
-				/*
-				 * a texture with the same filepath has already been loaded,
-				 * continue to next one. (optimization)
-				 */
-				skip = true;
+Texture Model::loadTexture(const std::string& path, const Texture_Type type)
+{
+	/* check if texture was loaded before and if so, return it: skip loading a new texture. (optimization) */
+	const auto loaded = textureIndices.find(path);
 
-				break;
-			}
-		}
+	if (loaded != textureIndices.end())
+	{
+		return textures_loaded[loaded->second];
+	}
 
-		if (!skip)
-		{
-			/* if texture hasn't been loaded already, load it */
-			Texture texture;
+	/* if the model doesn't use the texture yet, take a reference on the shared one (loaded by the first model) */
+	Texture texture;
 
-			texture.id = TextureFromFile(str.C_Str(), this->directory);
+	texture.id = TextureCache::acquire(this->directory + '/' + path, gammaCorrection);
 
-			texture.type = typeName;
+	texture.type = type;
 
-			texture.path = str.C_Str();
+	texture.path = path;
 
-			textures.push_back(texture);
+	textureReferences.emplace_back(texture.id);
 
-			/*
-			 * store it as texture loaded for entire model,
-			 * to ensure we won't unnecessary load duplicate textures.
-			 */
-			textures_loaded.push_back(texture);
-		}
-	}
+	textureIndices.emplace(path, textures_loaded.size());
 
-	return textures;
+	textures_loaded.push_back(texture);
+
+	return texture;
 }
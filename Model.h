@@ -2,24 +2,57 @@
 
 #ifndef MODEL_H
 #define MODEL_H
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "DrawBatch.h"
 #include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "TextureCache.h"
 
 struct aiNode;
 struct aiScene;
 struct aiMesh;
 struct aiMaterial;
 enum aiTextureType;
-struct Texture;
+class Camera;
 class Shader;
 
+/* import time processing, all off by default so models load exactly as exported */
+struct ModelLoadOptions
+{
+	/* reorder triangles and vertices of every mesh for the vertex cache, overdraw and vertex fetch */
+	bool optimizeMeshes = false;
+
+	/* append a chain of simplified levels of detail to every mesh's index buffer, for DrawLod */
+	bool generateLods = false;
+
+	/* split every mesh into meshlets so DrawCulled can skip clusters that are off screen or face away */
+	bool buildMeshlets = false;
+
+	/* free every mesh's vertices and indices once uploaded, Mesh::vertices and the index vectors are empty afterwards */
+	bool releaseCpuGeometry = false;
+
+	/*
+	 * load from the cooked file next to the source if it matches the source and these options, otherwise import with
+	 * assimp and write it (see ModelCooker). cooked meshes have no CPU copy, as if releaseCpuGeometry was set
+	 */
+	bool useCookedModel = false;
+
+	/* print the model's simulated ACMR/ATVR before and after optimizing, its vertex and index memory and LOD triangles */
+	bool reportMeshStats = false;
+};
+
 class Model
 {
 public:
 	/* Model Data */
 	// ------------------------------
-	/* stores all the textures loaded so far, optimization to make sure textures aren't loaded more than once. */
+	/*
+	 * stores all the textures loaded so far, once each. the textures themselves come from the TextureCache,
+	 * so models that use the same file share them.
+	 */
 	std::vector<Texture> textures_loaded;
 
 	std::vector<Mesh> meshes;
@@ -31,12 +64,79 @@ public:
 	/* Functions */
 	// ------------------------------
 	/* constructor, expects a filepath to a 3D model. */
-	Model(const std::string& path, bool gamma = false);
+	Model(const std::string& path, bool gamma = false, const ModelLoadOptions& options = ModelLoadOptions());
+
+	/* the meshes return their space in the geometry arena, which is compacted if that left too many holes */
+	~Model();
+
+	/* meshes are move-only owners of their arena allocations, so models are too */
+	Model(const Model&) = delete;
+
+	Model& operator=(const Model&) = delete;
+
+	Model(Model&&) = default;
 
-	/* draws the model, and thus all its meshes */
+	Model& operator=(Model&&) = default;
+
+	/*
+	 * draws the model, and thus all its meshes. shaders compiled with MESH_DRAW_BATCHED take the batched path,
+	 * one multi draw per material instead of one draw per mesh
+	 */
 	void Draw(const Shader& shader) const;
 
+	/* draws instanceCount copies of every mesh, per instance transforms come from GeometryArena::setInstanceMatrices */
+	void DrawInstanced(const Shader& shader, unsigned int instanceCount) const;
+
+	/*
+	 * draws the meshes with meshlet culling (built with ModelLoadOptions::buildMeshlets, meshes without meshlets draw whole).
+	 * model is the transform the shader is given, viewPosition is in world space. returns the culling counts.
+	 */
+	MeshletCullStats DrawCulled(const Shader& shader, const glm::mat4& model, const glm::mat4& viewProjection,
+	                            const glm::vec3& viewPosition) const;
+
+	/*
+	 * draws every mesh with the coarsest level of detail (ModelLoadOptions::generateLods) whose error stays within
+	 * errorPixels on screen. model is the transform the shader is given. returns the triangles drawn.
+	 */
+	MeshLodStats DrawLod(const Shader& shader, const glm::mat4& model, const Camera& camera, float viewportHeight,
+	                     float errorPixels = 1.f) const;
+
 private:
+	ModelLoadOptions options;
+
+	/* buckets and indirect commands of the batched path, created on its first use */
+	mutable std::unique_ptr<DrawBatch> batch;
+
+	/* vertex cache statistics of all meshes, before and after optimizing */
+	VertexCacheStats cacheStatsBefore;
+
+	VertexCacheStats cacheStatsAfter;
+
+	/* the model's reference on each entry of textures_loaded, the cache deletes a texture once no model holds one */
+	std::vector<TextureHandle> textureReferences;
+
+	/* path as the materials name it to its index in textures_loaded */
+	std::unordered_map<std::string, size_t> textureIndices;
+
+	/* fills meshes and textures from the cooked file */
+	friend class ModelCooker;
+
+	/* the CPU side of a mesh, made by importMesh on a worker thread */
+	struct ImportedMesh
+	{
+		std::vector<Vertex> vertices;
+
+		std::vector<unsigned int> indices;
+
+		std::vector<MeshLod> lods;
+
+		std::vector<Meshlet> meshlets;
+
+		VertexCacheStats cacheStatsBefore;
+
+		VertexCacheStats cacheStatsAfter;
+	};
+
 	/* Functions */
 	// ------------------------------
 	/* loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector. */
@@ -44,16 +144,23 @@ private:
 
 	/*
 	 * processes a node in a recursive fashion.
-	 * Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
+	 * Collects each individual mesh located at the node and repeats this process on its children nodes (if any).
 	 */
-	void processNode(aiNode* node, const aiScene* scene);
+	void processNode(aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& sceneMeshes);
 
-	Mesh processMesh(aiMesh* mesh, const aiScene* scene);
+	/* converts and processes a mesh's geometry, runs on the thread pool so it touches neither GL nor the model */
+	static ImportedMesh importMesh(const aiMesh* mesh, const ModelLoadOptions& options);
+
+	/* loads the mesh's textures and uploads it, on the GL thread */
+	Mesh processMesh(ImportedMesh imported, const aiMesh* mesh, const aiScene* scene);
 
 	/*
 	 * checks all material textures of a given type and loads the textures if they're not loaded yet.
 	 * the required info is returned as a Texture struct.
 	 */
-	std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName);
+	std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, Texture_Type textureType);
+
+	/* loads a texture relative to the model's directory, unless it was loaded before */
+	Texture loadTexture(const std::string& path, Texture_Type type);
 };
 #endif
@@ -0,0 +1,396 @@
+#include "ModelCooker.h"
+#include "GeometryArena.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "Model.h"
+#include "glad/glad.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <vector>
+
+namespace
+{
+	/* 'LGMC', bump the version whenever the layout or anything stored in it (PackedVertex, Meshlet) changes */
+	const uint32_t COOKED_MAGIC = 0x434D474C;
+
+	const uint32_t COOKED_VERSION = 1;
+
+	/* every table and blob starts at a multiple of this, so it can be used in place from the mapping */
+	const size_t COOKED_ALIGNMENT = 8;
+
+	/* offsets are from the start of the file */
+	struct CookedHeader
+	{
+		uint32_t magic;
+
+		uint32_t version;
+
+		uint64_t key;
+
+		uint32_t meshCount;
+
+		uint32_t textureCount;
+
+		uint64_t meshTableOffset;
+
+		uint64_t textureTableOffset;
+	};
+
+	struct CookedTexture
+	{
+		uint64_t pathOffset;
+
+		uint32_t pathLength;
+
+		uint32_t type;
+	};
+
+	struct CookedMesh
+	{
+		float positionScale[3];
+
+		float positionOffset[3];
+
+		uint32_t indexType;
+
+		uint32_t vertexCount;
+
+		uint64_t vertexOffset;
+
+		/* all levels of detail */
+		uint64_t indexCount;
+
+		uint64_t indexOffset;
+
+		uint32_t lodCount;
+
+		uint32_t meshletCount;
+
+		uint64_t lodOffset;
+
+		uint64_t meshletOffset;
+
+		/* indices into the texture table, in the mesh's texture order */
+		uint32_t textureCount;
+
+		uint32_t reserved;
+
+		uint64_t textureOffset;
+	};
+
+	/* appends data at the next aligned offset and returns that offset */
+	uint64_t append(std::vector<char>& file, const void* data, const size_t size)
+	{
+		file.resize((file.size() + COOKED_ALIGNMENT - 1) / COOKED_ALIGNMENT * COOKED_ALIGNMENT);
+
+		const auto offset = file.size();
+
+		file.insert(file.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+
+		return offset;
+	}
+
+	size_t indexSize(const uint32_t indexType)
+	{
+		return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+	}
+}
+
+std::string ModelCooker::cookedPath(const std::string& path)
+{
+	return path + ".cooked";
+}
+
+uint64_t ModelCooker::makeKey(const std::string& path, const ModelLoadOptions& options)
+{
+	struct stat status;
+
+	if (stat(path.c_str(), &status) != 0)
+	{
+		return 0;
+	}
+
+	/* size and modification time instead of the contents, checking the key must not cost a read of the source */
+	const auto size = static_cast<uint64_t>(status.st_size);
+
+	const auto modified = static_cast<uint64_t>(status.st_mtime);
+
+	const uint8_t flags[] = {options.optimizeMeshes, options.generateLods, options.buildMeshlets};
+
+	auto hash = hashBytes(&COOKED_VERSION, sizeof(COOKED_VERSION));
+
+	hash = hashBytes(&size, sizeof(size), hash);
+
+	hash = hashBytes(&modified, sizeof(modified), hash);
+
+	return hashBytes(flags, sizeof(flags), hash);
+}
+
+bool ModelCooker::load(const std::string& path, const ModelLoadOptions& options, Model& model)
+{
+	const auto key = makeKey(path, options);
+
+	MappedFile file;
+
+	if (key == 0 || !file.open(cookedPath(path)))
+	{
+		return false;
+	}
+
+	const auto base = file.data();
+
+	CookedHeader header;
+
+	if (!file.contains(0, sizeof(header)))
+	{
+		return false;
+	}
+
+	std::memcpy(&header, base, sizeof(header));
+
+	/* an outdated file is normal (the source or the format changed), it is simply cooked again */
+	if (header.magic != COOKED_MAGIC || header.version != COOKED_VERSION || header.key != key)
+	{
+		return false;
+	}
+
+	/* check every range once, the meshes are then built straight from the mapping */
+	auto valid = header.meshTableOffset % COOKED_ALIGNMENT == 0 && header.textureTableOffset % COOKED_ALIGNMENT == 0 &&
+		file.contains(header.meshTableOffset, header.meshCount * sizeof(CookedMesh)) &&
+		file.contains(header.textureTableOffset, header.textureCount * sizeof(CookedTexture));
+
+	const auto meshes = reinterpret_cast<const CookedMesh*>(base + header.meshTableOffset);
+
+	const auto textures = reinterpret_cast<const CookedTexture*>(base + header.textureTableOffset);
+
+	for (auto i = 0u; valid && i < header.textureCount; ++i)
+	{
+		valid = file.contains(textures[i].pathOffset, textures[i].pathLength) &&
+			textures[i].type <= static_cast<uint32_t>(Texture_Type::REFLECTION);
+	}
+
+	for (auto i = 0u; valid && i < header.meshCount; ++i)
+	{
+		const auto& mesh = meshes[i];
+
+		valid = (mesh.indexType == GL_UNSIGNED_SHORT || mesh.indexType == GL_UNSIGNED_INT) &&
+			mesh.vertexOffset % COOKED_ALIGNMENT == 0 && mesh.indexOffset % COOKED_ALIGNMENT == 0 &&
+			mesh.lodOffset % COOKED_ALIGNMENT == 0 && mesh.meshletOffset % COOKED_ALIGNMENT == 0 &&
+			mesh.textureOffset % COOKED_ALIGNMENT == 0 &&
+			file.contains(mesh.vertexOffset, mesh.vertexCount * sizeof(PackedVertex)) &&
+			file.contains(mesh.indexOffset, mesh.indexCount * indexSize(mesh.indexType)) &&
+			file.contains(mesh.lodOffset, mesh.lodCount * sizeof(MeshLod)) &&
+			file.contains(mesh.meshletOffset, mesh.meshletCount * sizeof(Meshlet)) &&
+			file.contains(mesh.textureOffset, mesh.textureCount * sizeof(uint32_t)) && mesh.lodCount > 0;
+
+		const auto lods = reinterpret_cast<const MeshLod*>(base + mesh.lodOffset);
+
+		for (auto lod = 0u; valid && lod < mesh.lodCount; ++lod)
+		{
+			valid = static_cast<uint64_t>(lods[lod].indexOffset) + lods[lod].indexCount <= mesh.indexCount;
+		}
+
+		const auto meshlets = reinterpret_cast<const Meshlet*>(base + mesh.meshletOffset);
+
+		for (auto meshlet = 0u; valid && meshlet < mesh.meshletCount; ++meshlet)
+		{
+			valid = static_cast<uint64_t>(meshlets[meshlet].indexOffset) + meshlets[meshlet].triangleCount * 3 <=
+				lods[0].indexCount;
+		}
+
+		const auto references = reinterpret_cast<const uint32_t*>(base + mesh.textureOffset);
+
+		for (auto texture = 0u; valid && texture < mesh.textureCount; ++texture)
+		{
+			valid = references[texture] < header.textureCount;
+		}
+	}
+
+	if (!valid)
+	{
+		std::cout << "ERROR::MODEL_COOKER::INVALID_FILE " << cookedPath(path) << std::endl;
+
+		return false;
+	}
+
+	model.directory = path.substr(0, path.find_last_of('/'));
+
+	std::vector<Texture> loaded;
+
+	loaded.reserve(header.textureCount);
+
+	for (auto i = 0u; i < header.textureCount; ++i)
+	{
+		loaded.push_back(model.loadTexture(std::string(base + textures[i].pathOffset, textures[i].pathLength),
+		                                   static_cast<Texture_Type>(textures[i].type)));
+	}
+
+	model.meshes.reserve(header.meshCount);
+
+	for (auto i = 0u; i < header.meshCount; ++i)
+	{
+		const auto& mesh = meshes[i];
+
+		PackedMesh packed;
+
+		packed.vertices = reinterpret_cast<const PackedVertex*>(base + mesh.vertexOffset);
+
+		packed.vertexCount = mesh.vertexCount;
+
+		packed.indices = base + mesh.indexOffset;
+
+		packed.indexCount = static_cast<size_t>(mesh.indexCount);
+
+		packed.indexType = mesh.indexType;
+
+		packed.positionScale = glm::vec3(mesh.positionScale[0], mesh.positionScale[1], mesh.positionScale[2]);
+
+		packed.positionOffset = glm::vec3(mesh.positionOffset[0], mesh.positionOffset[1], mesh.positionOffset[2]);
+
+		const auto lods = reinterpret_cast<const MeshLod*>(base + mesh.lodOffset);
+
+		const auto meshlets = reinterpret_cast<const Meshlet*>(base + mesh.meshletOffset);
+
+		const auto references = reinterpret_cast<const uint32_t*>(base + mesh.textureOffset);
+
+		std::vector<Texture> meshTextures;
+
+		for (auto texture = 0u; texture < mesh.textureCount; ++texture)
+		{
+			meshTextures.push_back(loaded[references[texture]]);
+		}
+
+		model.meshes.emplace_back(packed, std::move(meshTextures), std::vector<MeshLod>(lods, lods + mesh.lodCount),
+		                          std::vector<Meshlet>(meshlets, meshlets + mesh.meshletCount));
+	}
+
+	return true;
+}
+
+bool ModelCooker::store(const std::string& path, const ModelLoadOptions& options, const Model& model)
+{
+	const auto key = makeKey(path, options);
+
+	if (key == 0)
+	{
+		return false;
+	}
+
+	/* header and tables first, they are filled in once the blobs behind them are placed */
+	std::vector<char> file(sizeof(CookedHeader));
+
+	CookedHeader header{COOKED_MAGIC, COOKED_VERSION, key, static_cast<uint32_t>(model.meshes.size()), 0, 0, 0};
+
+	std::vector<CookedMesh> meshes(model.meshes.size());
+
+	header.meshTableOffset = append(file, meshes.data(), meshes.size() * sizeof(CookedMesh));
+
+	/* one table entry per texture file, meshes refer to them by index */
+	std::vector<const Texture*> textures;
+
+	std::vector<uint32_t> references;
+
+	std::vector<PackedVertex> vertexData;
+
+	std::vector<unsigned char> indexData;
+
+	for (auto i = 0u; i < model.meshes.size(); ++i)
+	{
+		const auto& mesh = model.meshes[i];
+
+		auto& cooked = meshes[i];
+
+		std::memset(&cooked, 0, sizeof(cooked));
+
+		if (mesh.getGeometry() == GeometryArena::INVALID)
+		{
+			return false;
+		}
+
+		/* the uploaded data itself, so the file holds exactly what is drawn */
+		GeometryArena::read(mesh.getGeometry(), vertexData, indexData);
+
+		for (auto axis = 0; axis < 3; ++axis)
+		{
+			cooked.positionScale[axis] = mesh.getPositionScale()[axis];
+
+			cooked.positionOffset[axis] = mesh.getPositionOffset()[axis];
+		}
+
+		cooked.indexType = mesh.getIndexType();
+
+		cooked.vertexCount = static_cast<uint32_t>(vertexData.size());
+
+		cooked.vertexOffset = append(file, vertexData.data(), vertexData.size() * sizeof(PackedVertex));
+
+		cooked.indexCount = indexData.size() / indexSize(cooked.indexType);
+
+		cooked.indexOffset = append(file, indexData.data(), indexData.size());
+
+		cooked.lodCount = static_cast<uint32_t>(mesh.getLods().size());
+
+		cooked.lodOffset = append(file, mesh.getLods().data(), mesh.getLods().size() * sizeof(MeshLod));
+
+		cooked.meshletCount = static_cast<uint32_t>(mesh.getMeshlets().size());
+
+		cooked.meshletOffset = append(file, mesh.getMeshlets().data(), mesh.getMeshlets().size() * sizeof(Meshlet));
+
+		references.clear();
+
+		for (const auto& texture : mesh.textures)
+		{
+			auto index = 0u;
+
+			while (index < textures.size() && textures[index]->path != texture.path)
+			{
+				++index;
+			}
+
+			if (index == textures.size())
+			{
+				textures.push_back(&texture);
+			}
+
+			references.push_back(index);
+		}
+
+		cooked.textureCount = static_cast<uint32_t>(references.size());
+
+		cooked.textureOffset = append(file, references.data(), references.size() * sizeof(uint32_t));
+	}
+
+	std::vector<CookedTexture> textureTable(textures.size());
+
+	for (auto i = 0u; i < textures.size(); ++i)
+	{
+		textureTable[i].pathLength = static_cast<uint32_t>(textures[i]->path.size());
+
+		textureTable[i].type = static_cast<uint32_t>(textures[i]->type);
+
+		textureTable[i].pathOffset = append(file, textures[i]->path.data(), textures[i]->path.size());
+	}
+
+	header.textureCount = static_cast<uint32_t>(textureTable.size());
+
+	header.textureTableOffset = append(file, textureTable.data(), textureTable.size() * sizeof(CookedTexture));
+
+	std::memcpy(file.data(), &header, sizeof(header));
+
+	std::memcpy(file.data() + header.meshTableOffset, meshes.data(), meshes.size() * sizeof(CookedMesh));
+
+	std::ofstream output(cookedPath(path), std::ios::binary | std::ios::trunc);
+
+	output.write(file.data(), static_cast<std::streamsize>(file.size()));
+
+	if (!output)
+	{
+		std::cout << "ERROR::MODEL_COOKER::WRITE_FAILED " << cookedPath(path) << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef MODEL_COOKER_H
+#define MODEL_COOKER_H
+
+#include <cstdint>
+#include <string>
+
+class Model;
+struct ModelLoadOptions;
+
+/*
+ * Cooked models (ModelLoadOptions::useCookedModel): after an assimp import the model is written next to its
+ * source ("rock.obj.cooked") exactly as it was uploaded, packed vertices and indices of every mesh with
+ * their levels of detail, meshlets, bounds and texture tables. Later loads map that file and upload straight
+ * from the mapping, nothing is parsed or converted. The file is keyed on the format version, the source file's
+ * size and modification time and the import options that change geometry, any mismatch falls back to assimp
+ * (which writes a new cooked file).
+ */
+class ModelCooker
+{
+public:
+	/* file the cooked form of a model source is stored in */
+	static std::string cookedPath(const std::string& path);
+
+	/* key a cooked file has to carry to be used for a source and options, 0 if the source doesn't exist */
+	static uint64_t makeKey(const std::string& path, const ModelLoadOptions& options);
+
+	/* fills an empty model from its cooked file, returns false (leaving the model empty) on a miss */
+	static bool load(const std::string& path, const ModelLoadOptions& options, Model& model);
+
+	/* writes a loaded model's cooked file, requires the context it was uploaded with */
+	static bool store(const std::string& path, const ModelLoadOptions& options, const Model& model);
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "ProgramBuild.h"
+#include "GLExtensions.h"
+#include "Shader.h"
+#include "ShaderCache.h"
+#include <initializer_list>
+#include <utility>
+
+namespace
+{
+	/* only compile here, compile errors are checked together with the link status once it completes */
+	unsigned int compile(const GLenum type, const std::string& code)
+	{
+		const auto shaderCode = code.c_str();
+
+		const auto shader = glCreateShader(type);
+
+		glShaderSource(shader, 1, &shaderCode, nullptr);
+
+		glCompileShader(shader);
+
+		return shader;
+	}
+}
+
+ProgramBuild::~ProgramBuild()
+{
+	reset();
+}
+
+ProgramBuild::ProgramBuild(ProgramBuild&& other) noexcept
+{
+	take(other);
+}
+
+ProgramBuild& ProgramBuild::operator=(ProgramBuild&& other) noexcept
+{
+	if (this != &other)
+	{
+		reset();
+
+		take(other);
+	}
+
+	return *this;
+}
+
+bool ProgramBuild::submit(const std::string& vertexCode, const std::string& fragmentCode,
+                          const std::string& geometryCode, const std::string& definesKey)
+{
+	reset();
+
+	program = glCreateProgram();
+
+	cacheKey = ShaderCache::makeKey(vertexCode, fragmentCode, geometryCode, definesKey);
+
+	if (ShaderCache::load(program, cacheKey))
+	{
+		return true;
+	}
+
+	vertex = compile(GL_VERTEX_SHADER, vertexCode);
+
+	fragment = compile(GL_FRAGMENT_SHADER, fragmentCode);
+
+	glAttachShader(program, vertex);
+
+	glAttachShader(program, fragment);
+
+	if (!geometryCode.empty())
+	{
+		geometry = compile(GL_GEOMETRY_SHADER, geometryCode);
+
+		glAttachShader(program, geometry);
+	}
+
+	ShaderCache::prepare(program);
+
+	glLinkProgram(program);
+
+	return false;
+}
+
+bool ProgramBuild::isComplete() const
+{
+	if (!GLEXT_KHR_parallel_shader_compile)
+	{
+		return true;
+	}
+
+	GLint complete = GL_FALSE;
+
+	glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &complete);
+
+	return complete == GL_TRUE;
+}
+
+bool ProgramBuild::finish()
+{
+	/* a program restored from the binary cache has no stages */
+	const auto compiled = vertex != 0;
+
+	auto success = true;
+
+	for (const auto& stage : {
+		     std::make_pair(vertex, "VERTEX"),
+		     std::make_pair(fragment, "FRAGMENT"),
+		     std::make_pair(geometry, "GEOMETRY")
+	     })
+	{
+		if (stage.first != 0)
+		{
+			success = Shader::checkCompileErrors(stage.first, stage.second) && success;
+		}
+	}
+
+	success = Shader::checkCompileErrors(program, "PROGRAM") && success;
+
+	deleteStages();
+
+	if (!success)
+	{
+		reset();
+
+		return false;
+	}
+
+	if (compiled)
+	{
+		ShaderCache::store(program, cacheKey);
+	}
+
+	return true;
+}
+
+unsigned int ProgramBuild::getProgram() const
+{
+	return program;
+}
+
+unsigned int ProgramBuild::release()
+{
+	const auto released = program;
+
+	program = 0;
+
+	return released;
+}
+
+void ProgramBuild::deleteStages()
+{
+	for (auto stage : {&vertex, &fragment, &geometry})
+	{
+		if (*stage != 0)
+		{
+			glDeleteShader(*stage);
+
+			*stage = 0;
+		}
+	}
+}
+
+void ProgramBuild::reset()
+{
+	deleteStages();
+
+	if (program != 0)
+	{
+		glDeleteProgram(program);
+
+		program = 0;
+	}
+}
+
+void ProgramBuild::take(ProgramBuild& other)
+{
+	vertex = other.vertex;
+
+	fragment = other.fragment;
+
+	geometry = other.geometry;
+
+	program = other.program;
+
+	cacheKey = other.cacheKey;
+
+	other.vertex = other.fragment = other.geometry = other.program = 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#ifndef PROGRAM_BUILD_H
+#define PROGRAM_BUILD_H
+
+#include <cstdint>
+#include <string>
+
+/*
+ * One program compiled and linked without blocking, shared by ShaderLibrary and ShaderReloader.
+ * submit() restores the program from the binary cache or issues the compiles and the link, isComplete() asks the
+ * driver whether it is done (GL_KHR_parallel_shader_compile) and finish() checks the results and stores the binary.
+ * The program and its stages are deleted with the object unless release() handed the program over (move-only).
+ */
+class ProgramBuild
+{
+public:
+	ProgramBuild() = default;
+
+	~ProgramBuild();
+
+	ProgramBuild(const ProgramBuild&) = delete;
+
+	ProgramBuild& operator=(const ProgramBuild&) = delete;
+
+	ProgramBuild(ProgramBuild&& other) noexcept;
+
+	ProgramBuild& operator=(ProgramBuild&& other) noexcept;
+
+	/*
+	 * creates the program from preprocessed sources (geometryCode may be empty).
+	 * returns true if it was restored from the binary cache, it is linked then and finish() isn't needed
+	 */
+	bool submit(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode,
+	            const std::string& definesKey);
+
+	/* true once compiling and linking is done, without the parallel compile extension it always is and finish() blocks */
+	bool isComplete() const;
+
+	/* checks compile and link status, deletes the stages and caches the binary. a failed program is deleted */
+	bool finish();
+
+	/* the program, 0 before submit, after a failure or after release */
+	unsigned int getProgram() const;
+
+	/* hands the program over to the caller, who deletes it from now on */
+	unsigned int release();
+
+private:
+	unsigned int vertex = 0;
+
+	unsigned int fragment = 0;
+
+	unsigned int geometry = 0;
+
+	unsigned int program = 0;
+
+	uint64_t cacheKey = 0;
+
+	void deleteStages();
+
+	void reset();
+
+	void take(ProgramBuild& other);
+};
+
+#endif
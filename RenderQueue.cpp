@@ -0,0 +1,211 @@
+#include "RenderQueue.h"
+#include "GeometryArena.h"
+#include "GLStateCache.h"
+#include "Hash.h"
+#include "Mesh.h"
+#include "Model.h"
+#include "Shader.h"
+#include <cstring>
+#include <utility>
+
+void RenderQueue::setViewPosition(const glm::vec3& position)
+{
+	viewPosition = position;
+}
+
+void RenderQueue::submit(const Render_Pass pass, const Shader& shader, const Mesh& mesh, const glm::mat4& model)
+{
+	uint64_t material = HASH_SEED;
+
+	for (const auto& texture : mesh.textures)
+	{
+		material = hashBytes(&texture.id, sizeof(texture.id), material);
+	}
+
+	items.push_back(Item{&shader, &mesh, model, material, pass});
+}
+
+void RenderQueue::submit(const Render_Pass pass, const Shader& shader, const Model& model, const glm::mat4& transform)
+{
+	for (const auto& mesh : model.meshes)
+	{
+		submit(pass, shader, mesh, transform);
+	}
+}
+
+void RenderQueue::flush()
+{
+	stats = RenderQueueStats();
+
+	entries.resize(items.size());
+
+	for (auto i = 0u; i < items.size(); ++i)
+	{
+		const auto& item = items[i];
+
+		/* distance to the centre of the mesh bounds */
+		const auto centre = item.mesh->getPositionOffset() + item.mesh->getPositionScale() * 0.5f;
+
+		const auto depth = glm::length(glm::vec3(item.model * glm::vec4(centre, 1.f)) - viewPosition);
+
+		entries[i].key = makeKey(item.pass, item.shader->ID, item.material, GeometryArena::getVertexArray(), depth);
+
+		entries[i].item = i;
+	}
+
+	radixSort(entries, scratch);
+
+	const Item* previous = nullptr;
+
+	/* the model matrix uniform of the current program, looked up when the program changes */
+	UniformHandle model;
+
+	for (const auto& entry : entries)
+	{
+		const auto& item = items[entry.item];
+
+		if (previous == nullptr || item.pass != previous->pass)
+		{
+			const auto transparent = item.pass == Render_Pass::TRANSPARENT_PASS;
+
+			GLStateCache::setEnabled(GL_BLEND, transparent);
+
+			if (transparent)
+			{
+				GLStateCache::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			}
+
+			GLStateCache::depthMask(!transparent);
+		}
+
+		const auto programChanged = previous == nullptr || item.shader != previous->shader;
+
+		if (programChanged)
+		{
+			item.shader->use();
+
+			model = item.shader->getUniform("model");
+
+			++stats.programChanges;
+		}
+
+		/* a new program has its own sampler uniforms, so rebind even if the textures are the same */
+		if (programChanged || item.material != previous->material)
+		{
+			item.mesh->bindTextures(*item.shader);
+
+			++stats.materialChanges;
+		}
+
+		item.shader->setMat4(model, item.model);
+
+		item.mesh->drawGeometry(*item.shader);
+
+		++stats.draws;
+
+		previous = &item;
+	}
+
+	/* leave blending off and depth writes on for whatever is drawn outside the queue */
+	GLStateCache::setEnabled(GL_BLEND, false);
+
+	GLStateCache::depthMask(true);
+
+	items.clear();
+}
+
+const RenderQueueStats& RenderQueue::getStats() const
+{
+	return stats;
+}
+
+void RenderQueue::radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+{
+	const auto count = entries.size();
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	scratch.resize(count);
+
+	/* all eight histograms in one read of the keys */
+	size_t histograms[8][256];
+
+	std::memset(histograms, 0, sizeof(histograms));
+
+	for (const auto& entry : entries)
+	{
+		for (auto digit = 0; digit < 8; ++digit)
+		{
+			++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+		}
+	}
+
+	auto source = &entries;
+
+	auto destination = &scratch;
+
+	for (auto digit = 0; digit < 8; ++digit)
+	{
+		auto& histogram = histograms[digit];
+
+		/* every key has the same value in this digit, the pass wouldn't move anything */
+		if (histogram[((*source)[0].key >> (digit * 8)) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+
+		for (auto& bucket : histogram)
+		{
+			const auto size = bucket;
+
+			bucket = offset;
+
+			offset += size;
+		}
+
+		for (const auto& entry : *source)
+		{
+			(*destination)[histogram[(entry.key >> (digit * 8)) & 0xFF]++] = entry;
+		}
+
+		std::swap(source, destination);
+	}
+
+	if (source != &entries)
+	{
+		entries.swap(scratch);
+	}
+}
+
+uint64_t RenderQueue::makeKey(const Render_Pass pass, const unsigned int program, const uint64_t material,
+                              const unsigned int vertexArray, const float depth)
+{
+	/* the bits of a non-negative float order like the float itself, keep the top 24 below the sign */
+	uint32_t depthBits;
+
+	const auto clamped = depth > 0.f ? depth : 0.f;
+
+	std::memcpy(&depthBits, &clamped, sizeof(depthBits));
+
+	const uint64_t depthKey = (depthBits >> 7) & 0xFFFFFF;
+
+	const auto passKey = static_cast<uint64_t>(pass) & 0x3;
+
+	const auto programKey = static_cast<uint64_t>(program) & 0x3FF;
+
+	const auto materialKey = (material ^ (material >> 16) ^ (material >> 32) ^ (material >> 48)) & 0xFFFF;
+
+	const auto vertexArrayKey = static_cast<uint64_t>(vertexArray) & 0xFFF;
+
+	if (pass == Render_Pass::TRANSPARENT_PASS)
+	{
+		return passKey << 62 | (~depthKey & 0xFFFFFF) << 38 | programKey << 28 | materialKey << 12 | vertexArrayKey;
+	}
+
+	return passKey << 62 | programKey << 52 | materialKey << 36 | vertexArrayKey << 24 | depthKey;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Mesh;
+class Model;
+class Shader;
+
+/* passes run in this order, each one sets its own blend and depth write state */
+enum class Render_Pass
+{
+	/* no blending, sorted by state and then front to back for early depth rejection */
+	OPAQUE_PASS,
+	/* alpha blended without depth writes, sorted back to front */
+	TRANSPARENT_PASS
+};
+
+/* what the last flush did */
+struct RenderQueueStats
+{
+	size_t draws = 0;
+
+	size_t programChanges = 0;
+
+	size_t materialChanges = 0;
+};
+
+/*
+ * Collects a frame's mesh draws and submits them sorted by a 64 bit key:
+ * opaque  | pass:2 | program:10 | material:16 | vertex array:12 | depth:24 |
+ * transparent | pass:2 | inverted depth:24 | program:10 | material:16 | vertex array:12 |
+ * so opaque draws are grouped by state and transparent draws strictly ordered back to front.
+ * The keys are radix sorted, and the submission loop only switches program and textures where they change.
+ * Shaders must use the per mesh path (not MESH_DRAW_BATCHED) and take their transform as "model".
+ */
+class RenderQueue
+{
+public:
+	/* eye position the depth of the draws is measured from, set before submitting */
+	void setViewPosition(const glm::vec3& position);
+
+	void submit(Render_Pass pass, const Shader& shader, const Mesh& mesh, const glm::mat4& model);
+
+	/* submits every mesh of a model with the same transform */
+	void submit(Render_Pass pass, const Shader& shader, const Model& model, const glm::mat4& transform);
+
+	/* sorts and draws everything submitted since the last flush, then empties the queue */
+	void flush();
+
+	const RenderQueueStats& getStats() const;
+
+private:
+	struct Item
+	{
+		const Shader* shader;
+
+		const Mesh* mesh;
+
+		glm::mat4 model;
+
+		/* hash of the texture set, decides where textures are rebound */
+		uint64_t material;
+
+		Render_Pass pass;
+	};
+
+	struct SortEntry
+	{
+		uint64_t key;
+
+		uint32_t item;
+	};
+
+	glm::vec3 viewPosition{};
+
+	std::vector<Item> items;
+
+	/* kept between frames so sorting doesn't allocate */
+	std::vector<SortEntry> entries;
+
+	std::vector<SortEntry> scratch;
+
+	RenderQueueStats stats;
+
+	/* least significant digit first, 8 bits per pass, passes where every key has the same digit are skipped */
+	static void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+	static uint64_t makeKey(Render_Pass pass, unsigned int program, uint64_t material, unsigned int vertexArray,
+	                        float depth);
+};
+
+#endif
@@ -1,10 +1,53 @@
 #include "Shader.h"
+#include "GLStateCache.h"
+#include "ShaderBundle.h"
+#include "ShaderCache.h"
+#include "UniformBuffer.h"
+#include <cstring>
 #include <iostream>
 #include <fstream>
 
+namespace
+{
+	bool isSamplerType(const GLenum type)
+	{
+		switch (type)
+		{
+		case GL_SAMPLER_1D:
+		case GL_SAMPLER_2D:
+		case GL_SAMPLER_3D:
+		case GL_SAMPLER_CUBE:
+		case GL_SAMPLER_1D_SHADOW:
+		case GL_SAMPLER_2D_SHADOW:
+		case GL_SAMPLER_CUBE_SHADOW:
+		case GL_SAMPLER_1D_ARRAY:
+		case GL_SAMPLER_2D_ARRAY:
+		case GL_SAMPLER_2D_ARRAY_SHADOW:
+		case GL_SAMPLER_2D_MULTISAMPLE:
+		case GL_SAMPLER_2D_RECT:
+		case GL_SAMPLER_BUFFER:
+		case GL_INT_SAMPLER_2D:
+		case GL_INT_SAMPLER_3D:
+		case GL_INT_SAMPLER_CUBE:
+		case GL_UNSIGNED_INT_SAMPLER_2D:
+		case GL_UNSIGNED_INT_SAMPLER_3D:
+		case GL_UNSIGNED_INT_SAMPLER_CUBE:
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
 Shader::Shader(const GLchar* vertexPath, const GLchar* fragmentPath, const char* geometryPath)
+	: Shader(vertexPath, fragmentPath, geometryPath, ShaderDefines())
 {
-	/* 1. retrieve the vertex/fragment source code from filePath */
+}
+
+Shader::Shader(const GLchar* vertexPath, const GLchar* fragmentPath, const char* geometryPath,
+               const ShaderDefines& defines)
+{
+	/* 1. retrieve the vertex/fragment source code from filePath, expanding includes and injecting the defines */
 	// ------------------------------
 	std::string vertexCode;
 
@@ -12,197 +55,713 @@ Shader::Shader(const GLchar* vertexPath, const GLchar* fragmentPath, const char*
 
 	std::string geometryCode;
 
-	std::ifstream vShaderFile;
+	/* if geometry shader path is present, also load a geometry shader */
+	const auto sourcesRead = ShaderPreprocessor::process(vertexPath, defines, vertexCode) &&
+		ShaderPreprocessor::process(fragmentPath, defines, fragmentCode) &&
+		(geometryPath == nullptr || ShaderPreprocessor::process(geometryPath, defines, geometryCode));
+
+	if (!sourcesRead)
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
+	}
+
+	/* 2. try the program binary cache before compiling anything */
+	// ------------------------------
+	const auto cacheKey = ShaderCache::makeKey(vertexCode, fragmentCode, geometryCode,
+	                                           ShaderPreprocessor::definesKey(defines));
+
+	ID = glCreateProgram();
 
-	std::ifstream fShaderFile;
+	if (ShaderCache::load(ID, cacheKey))
+	{
+		reflectUniforms();
 
-	std::ifstream gShaderFile;
+		return;
+	}
 
-	/* ensure ifstream objects can throw exceptions: */
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	/* 3. compile shaders */
+	// ------------------------------
+	/* vertex shader */
+	const auto vertex = compileShader(GL_VERTEX_SHADER, vertexCode, "VERTEX");
 
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	/* fragment Shader */
+	const auto fragment = compileShader(GL_FRAGMENT_SHADER, fragmentCode, "FRAGMENT");
 
-	gShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	/* if geometry shader is given, compile geometry shader */
+	unsigned int geometry = 0;
 
-	try
+	if (geometryPath != nullptr)
 	{
-		/* open files */
-		vShaderFile.open(vertexPath);
+		geometry = compileShader(GL_GEOMETRY_SHADER, geometryCode, "GEOMETRY");
+	}
 
-		fShaderFile.open(fragmentPath);
+	/* shader Program */
+	glAttachShader(ID, vertex);
+
+	glAttachShader(ID, fragment);
+
+	if (geometryPath != nullptr)
+	{
+		glAttachShader(ID, geometry);
+	}
 
-		std::stringstream vShaderStream, fShaderStream;
+	/* the binary can only be retrieved later if the hint is set before linking */
+	ShaderCache::prepare(ID);
 
-		/* read file's buffer contents into streams */
-		vShaderStream << vShaderFile.rdbuf();
+	glLinkProgram(ID);
 
-		fShaderStream << fShaderFile.rdbuf();
+	if (checkCompileErrors(ID, "PROGRAM"))
+	{
+		ShaderCache::store(ID, cacheKey);
+	}
 
-		/* close file handlers */
-		vShaderFile.close();
+	/* delete the shaders as they're linked into our program now and no longer necessary */
+	glDeleteShader(vertex);
 
-		fShaderFile.close();
+	glDeleteShader(fragment);
 
-		/* convert stream into string */
-		vertexCode = vShaderStream.str();
+	if (geometryPath != nullptr)
+	{
+		glDeleteShader(geometry);
+	}
 
-		fragmentCode = fShaderStream.str();
+	reflectUniforms();
+}
 
-		/* if geometry shader path is present, also load a geometry shader */
-		if (geometryPath != nullptr)
-		{
-			gShaderFile.open(geometryPath);
+Shader::Shader(const unsigned int program) : ID(program)
+{
+	reflectUniforms();
+}
 
-			std::stringstream gShaderStream;
+bool Shader::readSource(const char* path, std::string& code)
+{
+	const char* data;
 
-			gShaderStream << gShaderFile.rdbuf();
+	size_t size;
 
-			gShaderFile.close();
+	std::string storage;
 
-			geometryCode = gShaderStream.str();
-		}
-	}
-	catch (std::ifstream::failure& e)
+	if (!readSource(path, data, size, storage))
 	{
-		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
+		return false;
 	}
 
-	const auto vShaderCode = vertexCode.c_str();
+	code.assign(data, size);
 
-	const auto fShaderCode = fragmentCode.c_str();
+	return true;
+}
 
-	/* 2. compile shaders */
-	// ------------------------------
-	unsigned int vertex, fragment;
+bool Shader::readSource(const char* path, const char*& data, size_t& size, std::string& storage)
+{
+	if (ShaderBundle::find(path, data, size))
+	{
+		return true;
+	}
 
-	/* vertex shader */
-	vertex = glCreateShader(GL_VERTEX_SHADER);
+	/* loose file, one open and one read straight into the string */
+	std::ifstream shaderFile(path, std::ios::binary | std::ios::ate);
 
-	glShaderSource(vertex, 1, &vShaderCode, nullptr);
+	if (!shaderFile)
+	{
+		return false;
+	}
 
-	glCompileShader(vertex);
+	storage.resize(static_cast<size_t>(shaderFile.tellg()));
 
-	checkCompileErrors(vertex, "VERTEX");
+	shaderFile.seekg(0);
 
-	/* fragment Shader */
-	fragment = glCreateShader(GL_FRAGMENT_SHADER);
+	if (!shaderFile.read(&storage[0], static_cast<std::streamsize>(storage.size())))
+	{
+		return false;
+	}
 
-	glShaderSource(fragment, 1, &fShaderCode, nullptr);
+	data = storage.data();
 
-	glCompileShader(fragment);
+	size = storage.size();
 
-	checkCompileErrors(fragment, "FRAGMENT");
+	return true;
+}
 
-	/* if geometry shader is given, compile geometry shader */
-	unsigned int geometry;
+UniformUploadStats Shader::uploadStats = {};
 
-	if (geometryPath != nullptr)
-	{
-		const auto gShaderCode = geometryCode.c_str();
+bool UniformHandle::isValid() const
+{
+	return location >= 0;
+}
 
-		geometry = glCreateShader(GL_GEOMETRY_SHADER);
+bool UniformHandle::isSampler() const
+{
+	return isSamplerType(type);
+}
 
-		glShaderSource(geometry, 1, &gShaderCode, nullptr);
+bool UniformBlockInfo::isValid() const
+{
+	return index != GL_INVALID_INDEX;
+}
 
-		glCompileShader(geometry);
+void Shader::use() const
+{
+	GLStateCache::useProgram(ID);
+}
 
-		checkCompileErrors(geometry, "GEOMETRY");
-	}
+UniformHandle Shader::getUniform(const std::string& name) const
+{
+	const auto it = uniforms.find(name);
 
-	/* shader Program */
-	ID = glCreateProgram();
+	return it != uniforms.end() ? it->second : UniformHandle();
+}
 
-	glAttachShader(ID, vertex);
+GLint Shader::getUniformLocation(const std::string& name) const
+{
+	const auto it = uniforms.find(name);
 
-	glAttachShader(ID, fragment);
+	return it != uniforms.end() ? it->second.location : -1;
+}
 
-	if (geometryPath != nullptr)
+UniformBlockInfo Shader::getUniformBlock(const std::string& name) const
+{
+	const auto it = blocks.find(name);
+
+	return it != blocks.end() ? it->second : UniformBlockInfo();
+}
+
+void Shader::flush() const
+{
+	if (dirtySlots.empty())
 	{
-		glAttachShader(ID, geometry);
+		return;
 	}
 
-	glLinkProgram(ID);
+	GLStateCache::useProgram(ID);
 
-	checkCompileErrors(ID, "PROGRAM");
+	for (const auto index : dirtySlots)
+	{
+		auto& slot = slots[index];
 
-	/* delete the shaders as they're linked into our program now and no longer necessary */
-	glDeleteShader(vertex);
+		const auto count = slot.dirtyLast - slot.dirtyFirst + 1;
 
-	glDeleteShader(fragment);
+		upload(slot.type, locations[slot.firstLocation + slot.dirtyFirst], count,
+		       &values[slot.offset + slot.dirtyFirst * slot.elementSize]);
 
-	if (geometryPath != nullptr)
+		uploadStats.uploadedBytes += count * slot.elementSize;
+
+		++uploadStats.uploadCalls;
+
+		slot.dirtyFirst = slot.count;
+
+		slot.dirtyLast = -1;
+	}
+
+	dirtySlots.clear();
+}
+
+void Shader::copyUniformValues(const Shader& other)
+{
+	for (const auto& source : other.slots)
 	{
-		glDeleteShader(geometry);
+		const auto it = uniforms.find(source.name);
+
+		if (it == uniforms.end() || it->second.type != source.type)
+		{
+			continue;
+		}
+
+		const auto& target = slots[it->second.slot];
+
+		const auto count = target.count < source.count ? target.count : source.count;
+
+		for (auto element = 0; element < count; ++element)
+		{
+			auto handle = it->second;
+
+			handle.element = element;
+
+			write(handle, kindOf(source.type), &other.values[source.offset + element * source.elementSize],
+			      source.elementSize);
+		}
 	}
 }
 
-void Shader::use() const
+const UniformUploadStats& Shader::getUploadStats()
 {
-	glUseProgram(ID);
+	return uploadStats;
+}
+
+void Shader::resetUploadStats()
+{
+	uploadStats = {};
 }
 
 void Shader::setBool(const std::string& name, const bool value) const
 {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), static_cast<int>(value));
+	setBool(getUniform(name), value);
 }
 
 void Shader::setInt(const std::string& name, const int value) const
 {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+	setInt(getUniform(name), value);
 }
 
 void Shader::setFloat(const std::string& name, const float value) const
 {
-	glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+	setFloat(getUniform(name), value);
 }
 
 void Shader::setVec2(const std::string& name, const glm::vec2& value) const
 {
-	glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+	setVec2(getUniform(name), value);
 }
 
 void Shader::setVec2(const std::string& name, const float x, const float y) const
 {
-	glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+	setVec2(getUniform(name), glm::vec2(x, y));
 }
 
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const
 {
-	glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+	setVec3(getUniform(name), value);
 }
 
 void Shader::setVec3(const std::string& name, const float x, const float y, const float z) const
 {
-	glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+	setVec3(getUniform(name), glm::vec3(x, y, z));
 }
 
 void Shader::setVec4(const std::string& name, const glm::vec4& value) const
 {
-	glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+	setVec4(getUniform(name), value);
 }
 
-void Shader::setVec4(const std::string& name, const float x, const float y, const float z, const float w)
+void Shader::setVec4(const std::string& name, const float x, const float y, const float z, const float w) const
 {
-	glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+	setVec4(getUniform(name), glm::vec4(x, y, z, w));
 }
 
 void Shader::setMat2(const std::string& name, const glm::mat2& mat) const
 {
-	glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	setMat2(getUniform(name), mat);
 }
 
 void Shader::setMat3(const std::string& name, const glm::mat3& mat) const
 {
-	glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	setMat3(getUniform(name), mat);
 }
 
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
 {
-	glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	setMat4(getUniform(name), mat);
+}
+
+void Shader::setBool(const UniformHandle handle, const bool value) const
+{
+	const auto intValue = static_cast<int>(value);
+
+	write(handle, UniformKind::Int, &intValue, sizeof(intValue));
+}
+
+void Shader::setInt(const UniformHandle handle, const int value) const
+{
+	write(handle, UniformKind::Int, &value, sizeof(value));
+}
+
+void Shader::setFloat(const UniformHandle handle, const float value) const
+{
+	write(handle, UniformKind::Float, &value, sizeof(value));
+}
+
+void Shader::setVec2(const UniformHandle handle, const glm::vec2& value) const
+{
+	write(handle, UniformKind::Float, &value[0], sizeof(value));
 }
 
-void Shader::checkCompileErrors(const unsigned shader, const std::string type)
+void Shader::setVec3(const UniformHandle handle, const glm::vec3& value) const
+{
+	write(handle, UniformKind::Float, &value[0], sizeof(value));
+}
+
+void Shader::setVec4(const UniformHandle handle, const glm::vec4& value) const
+{
+	write(handle, UniformKind::Float, &value[0], sizeof(value));
+}
+
+void Shader::setMat2(const UniformHandle handle, const glm::mat2& mat) const
+{
+	write(handle, UniformKind::Float, &mat[0][0], sizeof(mat));
+}
+
+void Shader::setMat3(const UniformHandle handle, const glm::mat3& mat) const
+{
+	write(handle, UniformKind::Float, &mat[0][0], sizeof(mat));
+}
+
+void Shader::setMat4(const UniformHandle handle, const glm::mat4& mat) const
+{
+	write(handle, UniformKind::Float, &mat[0][0], sizeof(mat));
+}
+
+void Shader::reflectUniforms()
+{
+	/* shared blocks always live at their fixed binding points, GLSL 330 can't declare the binding itself */
+	for (const auto& block : SHARED_UNIFORM_BLOCKS)
+	{
+		const auto index = glGetUniformBlockIndex(ID, block.name);
+
+		if (index != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(ID, index, block.binding);
+		}
+	}
+
+	uniforms.clear();
+
+	blocks.clear();
+
+	slots.clear();
+
+	locations.clear();
+
+	values.clear();
+
+	dirtySlots.clear();
+
+	GLint count = 0;
+
+	GLint maxLength = 0;
+
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+
+	std::string buffer(static_cast<size_t>(maxLength > 0 ? maxLength : 1), '\0');
+
+	for (auto i = 0; i < count; ++i)
+	{
+		GLsizei length = 0;
+
+		UniformBlockInfo block;
+
+		block.index = static_cast<GLuint>(i);
+
+		glGetActiveUniformBlockName(ID, block.index, maxLength, &length, &buffer[0]);
+
+		glGetActiveUniformBlockiv(ID, block.index, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+
+		glGetActiveUniformBlockiv(ID, block.index, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+
+		blocks[buffer.substr(0, static_cast<size_t>(length))] = block;
+	}
+
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	buffer.assign(static_cast<size_t>(maxLength > 0 ? maxLength : 1), '\0');
+
+	for (auto i = 0; i < count; ++i)
+	{
+		GLsizei length = 0;
+
+		UniformHandle handle;
+
+		glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &handle.size, &handle.type, &buffer[0]);
+
+		auto name = buffer.substr(0, static_cast<size_t>(length));
+
+		/* members of uniform blocks have no location and are not set through glUniform* */
+		handle.location = glGetUniformLocation(ID, name.c_str());
+
+		const auto elementSize = sizeOf(handle.type);
+
+		if (handle.location < 0 || elementSize == 0)
+		{
+			continue;
+		}
+
+		/* arrays are reported once as "name[0]", register the plain name and every element */
+		const auto bracket = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0
+			                     ? name.size() - 3
+			                     : std::string::npos;
+
+		const auto baseName = bracket == std::string::npos ? name : name.substr(0, bracket);
+
+		UniformSlot slot;
+
+		slot.name = baseName;
+
+		slot.type = handle.type;
+
+		slot.count = handle.size;
+
+		slot.elementSize = elementSize;
+
+		slot.offset = values.size();
+
+		slot.firstLocation = locations.size();
+
+		slot.dirtyFirst = slot.count;
+
+		slot.dirtyLast = -1;
+
+		handle.slot = static_cast<GLint>(slots.size());
+
+		slots.push_back(slot);
+
+		values.resize(values.size() + slot.count * elementSize);
+
+		uniforms[baseName] = handle;
+
+		for (auto element = 0; element < handle.size; ++element)
+		{
+			auto elementHandle = handle;
+
+			if (bracket != std::string::npos)
+			{
+				const auto elementName = baseName + '[' + std::to_string(element) + ']';
+
+				elementHandle.location = glGetUniformLocation(ID, elementName.c_str());
+
+				elementHandle.size = handle.size - element;
+
+				elementHandle.element = element;
+
+				uniforms[elementName] = elementHandle;
+			}
+
+			locations.push_back(elementHandle.location);
+
+			/* start from what the program actually holds (zero or the GLSL initialiser) */
+			const auto value = &values[slot.offset + element * elementSize];
+
+			switch (kindOf(handle.type))
+			{
+			case UniformKind::Float:
+				glGetUniformfv(ID, elementHandle.location, reinterpret_cast<GLfloat*>(value));
+				break;
+			case UniformKind::UnsignedInt:
+				glGetUniformuiv(ID, elementHandle.location, reinterpret_cast<GLuint*>(value));
+				break;
+			default:
+				glGetUniformiv(ID, elementHandle.location, reinterpret_cast<GLint*>(value));
+				break;
+			}
+		}
+	}
+}
+
+void Shader::write(const UniformHandle handle, const UniformKind kind, const void* data, const size_t size) const
+{
+	if (handle.slot < 0)
+	{
+		return;
+	}
+
+	auto& slot = slots[handle.slot];
+
+	/* a mismatching setter is ignored, just like glUniform* would reject it */
+	if (kindOf(slot.type) != kind || size != static_cast<size_t>(slot.elementSize))
+	{
+		return;
+	}
+
+	const auto value = &values[slot.offset + handle.element * slot.elementSize];
+
+	if (std::memcmp(value, data, size) == 0)
+	{
+		uploadStats.skippedBytes += size;
+
+		return;
+	}
+
+	std::memcpy(value, data, size);
+
+	if (slot.dirtyFirst > slot.dirtyLast)
+	{
+		dirtySlots.push_back(static_cast<size_t>(handle.slot));
+	}
+
+	if (handle.element < slot.dirtyFirst)
+	{
+		slot.dirtyFirst = handle.element;
+	}
+
+	if (handle.element > slot.dirtyLast)
+	{
+		slot.dirtyLast = handle.element;
+	}
+}
+
+Shader::UniformKind Shader::kindOf(const GLenum type)
+{
+	switch (type)
+	{
+	case GL_FLOAT:
+	case GL_FLOAT_VEC2:
+	case GL_FLOAT_VEC3:
+	case GL_FLOAT_VEC4:
+	case GL_FLOAT_MAT2:
+	case GL_FLOAT_MAT3:
+	case GL_FLOAT_MAT4:
+	case GL_FLOAT_MAT2x3:
+	case GL_FLOAT_MAT2x4:
+	case GL_FLOAT_MAT3x2:
+	case GL_FLOAT_MAT3x4:
+	case GL_FLOAT_MAT4x2:
+	case GL_FLOAT_MAT4x3:
+		return UniformKind::Float;
+	case GL_UNSIGNED_INT:
+	case GL_UNSIGNED_INT_VEC2:
+	case GL_UNSIGNED_INT_VEC3:
+	case GL_UNSIGNED_INT_VEC4:
+		return UniformKind::UnsignedInt;
+	case GL_INT:
+	case GL_INT_VEC2:
+	case GL_INT_VEC3:
+	case GL_INT_VEC4:
+	case GL_BOOL:
+	case GL_BOOL_VEC2:
+	case GL_BOOL_VEC3:
+	case GL_BOOL_VEC4:
+		return UniformKind::Int;
+	default:
+		return isSamplerType(type) ? UniformKind::Int : UniformKind::Unsupported;
+	}
+}
+
+GLint Shader::sizeOf(const GLenum type)
+{
+	switch (type)
+	{
+	case GL_FLOAT_VEC2:
+	case GL_INT_VEC2:
+	case GL_BOOL_VEC2:
+	case GL_UNSIGNED_INT_VEC2:
+		return 8;
+	case GL_FLOAT_VEC3:
+	case GL_INT_VEC3:
+	case GL_BOOL_VEC3:
+	case GL_UNSIGNED_INT_VEC3:
+		return 12;
+	case GL_FLOAT_VEC4:
+	case GL_INT_VEC4:
+	case GL_BOOL_VEC4:
+	case GL_UNSIGNED_INT_VEC4:
+	case GL_FLOAT_MAT2:
+		return 16;
+	case GL_FLOAT_MAT2x3:
+	case GL_FLOAT_MAT3x2:
+		return 24;
+	case GL_FLOAT_MAT2x4:
+	case GL_FLOAT_MAT4x2:
+		return 32;
+	case GL_FLOAT_MAT3:
+		return 36;
+	case GL_FLOAT_MAT3x4:
+	case GL_FLOAT_MAT4x3:
+		return 48;
+	case GL_FLOAT_MAT4:
+		return 64;
+	default:
+		/* scalars and samplers, 0 for anything the setters can't write */
+		return kindOf(type) == UniformKind::Unsupported ? 0 : 4;
+	}
+}
+
+void Shader::upload(const GLenum type, const GLint location, const GLsizei count, const void* data)
+{
+	const auto floats = static_cast<const GLfloat*>(data);
+
+	const auto ints = static_cast<const GLint*>(data);
+
+	const auto uints = static_cast<const GLuint*>(data);
+
+	switch (type)
+	{
+	case GL_FLOAT:
+		glUniform1fv(location, count, floats);
+		break;
+	case GL_FLOAT_VEC2:
+		glUniform2fv(location, count, floats);
+		break;
+	case GL_FLOAT_VEC3:
+		glUniform3fv(location, count, floats);
+		break;
+	case GL_FLOAT_VEC4:
+		glUniform4fv(location, count, floats);
+		break;
+	case GL_FLOAT_MAT2:
+		glUniformMatrix2fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT3:
+		glUniformMatrix3fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT4:
+		glUniformMatrix4fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT2x3:
+		glUniformMatrix2x3fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT2x4:
+		glUniformMatrix2x4fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT3x2:
+		glUniformMatrix3x2fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT3x4:
+		glUniformMatrix3x4fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT4x2:
+		glUniformMatrix4x2fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_FLOAT_MAT4x3:
+		glUniformMatrix4x3fv(location, count, GL_FALSE, floats);
+		break;
+	case GL_UNSIGNED_INT:
+		glUniform1uiv(location, count, uints);
+		break;
+	case GL_UNSIGNED_INT_VEC2:
+		glUniform2uiv(location, count, uints);
+		break;
+	case GL_UNSIGNED_INT_VEC3:
+		glUniform3uiv(location, count, uints);
+		break;
+	case GL_UNSIGNED_INT_VEC4:
+		glUniform4uiv(location, count, uints);
+		break;
+	case GL_INT_VEC2:
+	case GL_BOOL_VEC2:
+		glUniform2iv(location, count, ints);
+		break;
+	case GL_INT_VEC3:
+	case GL_BOOL_VEC3:
+		glUniform3iv(location, count, ints);
+		break;
+	case GL_INT_VEC4:
+	case GL_BOOL_VEC4:
+		glUniform4iv(location, count, ints);
+		break;
+	default:
+		/* int, bool and samplers */
+		glUniform1iv(location, count, ints);
+		break;
+	}
+}
+
+unsigned int Shader::compileShader(const GLenum type, const std::string& code, const std::string& typeName)
+{
+	const auto shaderCode = code.c_str();
+
+	const auto shader = glCreateShader(type);
+
+	glShaderSource(shader, 1, &shaderCode, nullptr);
+
+	glCompileShader(shader);
+
+	checkCompileErrors(shader, typeName);
+
+	return shader;
+}
+
+bool Shader::checkCompileErrors(const unsigned shader, const std::string type)
 {
 	int success;
 
@@ -232,4 +791,6 @@ void Shader::checkCompileErrors(const unsigned shader, const std::string type)
 				"\n -- --------------------------------------------------- -- " << std::endl;
 		}
 	}
+
+	return success != 0;
 }
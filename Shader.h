@@ -7,7 +7,58 @@
 #include <glm/glm.hpp>
 #include <string>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "ShaderPreprocessor.h"
 
+/* resolved location of an active uniform, fetch it once and reuse it in hot loops without any name lookup */
+struct UniformHandle
+{
+	GLint location = -1;
+
+	/* GL type as reported by reflection (GL_FLOAT_VEC3, GL_SAMPLER_2D, ...) */
+	GLenum type = GL_NONE;
+
+	/* number of array elements, 1 for non-array uniforms */
+	GLint size = 0;
+
+	/* entry in the shader's uniform table and the array element this handle starts at */
+	GLint slot = -1;
+
+	GLint element = 0;
+
+	bool isValid() const;
+
+	bool isSampler() const;
+};
+
+/* an active uniform block, its contents come from a UniformBuffer rather than the uniform setters */
+struct UniformBlockInfo
+{
+	GLuint index = GL_INVALID_INDEX;
+
+	GLint binding = -1;
+
+	/* minimum buffer size the block needs */
+	GLint dataSize = 0;
+
+	bool isValid() const;
+};
+
+/* bytes passed to glUniform* versus bytes dropped because the program already held the value */
+struct UniformUploadStats
+{
+	size_t uploadedBytes;
+
+	size_t skippedBytes;
+
+	unsigned int uploadCalls;
+};
+
+/*
+ * The uniform setters only write a CPU copy of the program's uniforms (read back from the program at link time),
+ * writes that don't change a value are dropped. flush() uploads whatever changed, call it right before drawing.
+ */
 class Shader
 {
 public:
@@ -16,9 +67,45 @@ public:
 	/* constructor generates the shader on the fly */
 	Shader(const GLchar* vertexPath, const GLchar* fragmentPath, const char* geometryPath = nullptr);
 
+	/* builds a specialised variant, the defines are injected into every stage after the #version line */
+	Shader(const GLchar* vertexPath, const GLchar* fragmentPath, const char* geometryPath,
+	       const ShaderDefines& defines);
+
+	/* adopts an already linked program, used by ShaderLibrary once an asynchronous link completes */
+	explicit Shader(unsigned int program);
+
+	/* reads a whole shader source file, returns false if it can't be read */
+	static bool readSource(const char* path, std::string& code);
+
+	/*
+	 * points data at a shader source without copying it when the shader bundle holds the file,
+	 * loose files are read into storage. returns false if the file can't be found.
+	 */
+	static bool readSource(const char* path, const char*& data, size_t& size, std::string& storage);
+
 	/* activate the shader */
 	void use() const;
 
+	/* returns the handle of an active uniform, an invalid handle if the program doesn't declare it */
+	UniformHandle getUniform(const std::string& name) const;
+
+	/* returns the cached location of an active uniform, -1 if the program doesn't declare it */
+	GLint getUniformLocation(const std::string& name) const;
+
+	/* returns an active uniform block, an invalid one if the program doesn't declare it */
+	UniformBlockInfo getUniformBlock(const std::string& name) const;
+
+	/* binds the program and uploads the uniforms changed since the last flush, one call per changed uniform (or array range) */
+	void flush() const;
+
+	/* takes over the values of every uniform that exists with the same name and type in the other program */
+	void copyUniformValues(const Shader& other);
+
+	/* counters since the last resetUploadStats, shared by all programs */
+	static const UniformUploadStats& getUploadStats();
+
+	static void resetUploadStats();
+
 	/* utility uniform functions */
 	void setBool(const std::string& name, bool value) const;
 
@@ -36,7 +123,7 @@ public:
 
 	void setVec4(const std::string& name, const glm::vec4& value) const;
 
-	void setVec4(const std::string& name, float x, float y, float z, float w);
+	void setVec4(const std::string& name, float x, float y, float z, float w) const;
 
 	void setMat2(const std::string& name, const glm::mat2& mat) const;
 
@@ -44,9 +131,99 @@ public:
 
 	void setMat4(const std::string& name, const glm::mat4& mat) const;
 
+	/* handle based uniform functions, no string hashing or driver lookup */
+	void setBool(UniformHandle handle, bool value) const;
+
+	void setInt(UniformHandle handle, int value) const;
+
+	void setFloat(UniformHandle handle, float value) const;
+
+	void setVec2(UniformHandle handle, const glm::vec2& value) const;
+
+	void setVec3(UniformHandle handle, const glm::vec3& value) const;
+
+	void setVec4(UniformHandle handle, const glm::vec4& value) const;
+
+	void setMat2(UniformHandle handle, const glm::mat2& mat) const;
+
+	void setMat3(UniformHandle handle, const glm::mat3& mat) const;
+
+	void setMat4(UniformHandle handle, const glm::mat4& mat) const;
+
 private:
-	/* utility function for checking shader compilation/linking errors. */
-	static void checkCompileErrors(unsigned int shader, std::string type);
+	friend class ProgramBuild;
+
+	friend class ShaderCooker;
+
+	/* one entry per active uniform, arrays are a single entry */
+	struct UniformSlot
+	{
+		std::string name;
+
+		GLenum type;
+
+		GLint count;
+
+		/* bytes per array element */
+		GLint elementSize;
+
+		/* byte offset of the first element in values */
+		size_t offset;
+
+		/* index of the first element's location in locations */
+		size_t firstLocation;
+
+		/* range of elements written since the last flush, empty while dirtyFirst > dirtyLast */
+		GLint dirtyFirst;
+
+		GLint dirtyLast;
+	};
+
+	/* the component type a setter writes, values are only accepted by uniforms of the same kind */
+	enum class UniformKind
+	{
+		Float,
+		Int,
+		UnsignedInt,
+		Unsupported
+	};
+
+	/* active uniforms of the linked program keyed by name, array elements are stored as both "name" and "name[i]" */
+	std::unordered_map<std::string, UniformHandle> uniforms;
+
+	std::unordered_map<std::string, UniformBlockInfo> blocks;
+
+	mutable std::vector<UniformSlot> slots;
+
+	/* location of every array element of every slot */
+	std::vector<GLint> locations;
+
+	/* CPU copy of all uniform values, laid out slot after slot */
+	mutable std::vector<unsigned char> values;
+
+	/* slots with a non-empty dirty range */
+	mutable std::vector<size_t> dirtySlots;
+
+	static UniformUploadStats uploadStats;
+
+	/* fills the uniform table and the value copy from the linked program, binds the shared uniform blocks, called once after linking */
+	void reflectUniforms();
+
+	/* stores a value into the copy and marks it dirty if it changed */
+	void write(UniformHandle handle, UniformKind kind, const void* data, size_t size) const;
+
+	static UniformKind kindOf(GLenum type);
+
+	/* bytes per element of a uniform type, 0 for types the setters don't support */
+	static GLint sizeOf(GLenum type);
+
+	static void upload(GLenum type, GLint location, GLsizei count, const void* data);
+
+	/* compiles a single stage, errors are reported through checkCompileErrors */
+	static unsigned int compileShader(GLenum type, const std::string& code, const std::string& typeName);
+
+	/* utility function for checking shader compilation/linking errors, returns true on success. */
+	static bool checkCompileErrors(unsigned int shader, std::string type);
 };
 
 #endif
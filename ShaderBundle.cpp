@@ -0,0 +1,343 @@
+#include "ShaderBundle.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+	const uint32_t BUNDLE_MAGIC = 0x4253474C; /* "LGSB" */
+
+	const uint32_t BUNDLE_VERSION = 1;
+
+	struct BundleHeader
+	{
+		uint32_t magic;
+
+		uint32_t version;
+
+		uint32_t count;
+
+		uint32_t reserved;
+	};
+
+	/* offsets are from the start of the file, the index is sorted by path */
+	struct BundleEntry
+	{
+		uint32_t pathOffset;
+
+		uint32_t pathLength;
+
+		uint32_t dataOffset;
+
+		uint32_t dataLength;
+	};
+
+	std::string normalise(std::string path)
+	{
+		std::replace(path.begin(), path.end(), '\\', '/');
+
+		return path;
+	}
+
+	/* appends the paths of all files below directory, relative to it */
+	void collectFiles(const std::string& directory, const std::string& relative, std::vector<std::string>& files)
+	{
+#ifdef _WIN32
+		WIN32_FIND_DATAA data;
+
+		const auto find = FindFirstFileA((directory + '/' + relative + '*').c_str(), &data);
+
+		if (find == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		do
+		{
+			const std::string name = data.cFileName;
+
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				collectFiles(directory, relative + name + '/', files);
+			}
+			else
+			{
+				files.push_back(relative + name);
+			}
+		}
+		while (FindNextFileA(find, &data));
+
+		FindClose(find);
+#else
+		const auto dir = opendir((directory + '/' + relative).c_str());
+
+		if (dir == nullptr)
+		{
+			return;
+		}
+
+		while (const auto entry = readdir(dir))
+		{
+			const std::string name = entry->d_name;
+
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			struct stat status;
+
+			if (stat((directory + '/' + relative + name).c_str(), &status) != 0)
+			{
+				continue;
+			}
+
+			if (S_ISDIR(status.st_mode))
+			{
+				collectFiles(directory, relative + name + '/', files);
+			}
+			else
+			{
+				files.push_back(relative + name);
+			}
+		}
+
+		closedir(dir);
+#endif
+	}
+}
+
+MappedFile ShaderBundle::file;
+
+bool ShaderBundle::open(const std::string& path)
+{
+	close();
+
+	if (!file.open(path))
+	{
+		return false;
+	}
+
+	const auto base = file.data();
+
+	const auto size = file.size();
+
+	/* validate the index once, lookups trust it afterwards */
+	BundleHeader header;
+
+	auto valid = size >= sizeof(header);
+
+	if (valid)
+	{
+		std::memcpy(&header, base, sizeof(header));
+
+		valid = header.magic == BUNDLE_MAGIC && header.version == BUNDLE_VERSION &&
+			sizeof(header) + static_cast<size_t>(header.count) * sizeof(BundleEntry) <= size;
+	}
+
+	for (auto i = 0u; valid && i < header.count; ++i)
+	{
+		BundleEntry entry;
+
+		std::memcpy(&entry, base + sizeof(header) + i * sizeof(entry), sizeof(entry));
+
+		valid = static_cast<size_t>(entry.pathOffset) + entry.pathLength <= size &&
+			static_cast<size_t>(entry.dataOffset) + entry.dataLength <= size;
+	}
+
+	if (!valid)
+	{
+		std::cout << "ERROR::SHADER_BUNDLE::INVALID_BUNDLE " << path << std::endl;
+
+		close();
+	}
+
+	return valid;
+}
+
+void ShaderBundle::close()
+{
+	file.close();
+}
+
+bool ShaderBundle::isOpen()
+{
+	return file.data() != nullptr;
+}
+
+bool ShaderBundle::find(const std::string& path, const char*& data, size_t& size)
+{
+	const auto base = file.data();
+
+	if (base == nullptr)
+	{
+		return false;
+	}
+
+	const auto key = normalise(path);
+
+	BundleHeader header;
+
+	std::memcpy(&header, base, sizeof(header));
+
+	const auto entries = base + sizeof(header);
+
+	/* binary search on the sorted index */
+	size_t first = 0;
+
+	size_t last = header.count;
+
+	while (first < last)
+	{
+		const auto middle = first + (last - first) / 2;
+
+		BundleEntry entry;
+
+		std::memcpy(&entry, entries + middle * sizeof(entry), sizeof(entry));
+
+		const auto order = key.compare(0, std::string::npos, base + entry.pathOffset, entry.pathLength);
+
+		if (order == 0)
+		{
+			data = base + entry.dataOffset;
+
+			size = entry.dataLength;
+
+			return true;
+		}
+
+		if (order < 0)
+		{
+			last = middle;
+		}
+		else
+		{
+			first = middle + 1;
+		}
+	}
+
+	return false;
+}
+
+std::vector<std::string> ShaderBundle::listFiles(const std::string& directory)
+{
+	const auto root = normalise(directory);
+
+	std::vector<std::string> files;
+
+	collectFiles(root, std::string(), files);
+
+	for (auto& file : files)
+	{
+		file = root + '/' + file;
+	}
+
+	std::sort(files.begin(), files.end());
+
+	return files;
+}
+
+bool ShaderBundle::pack(const std::string& directory, const std::string& bundlePath,
+                        const std::map<std::string, std::string>& generated)
+{
+	/* keys are the paths the shaders are loaded by, the map keeps them sorted for the binary search */
+	auto files = generated;
+
+	for (const auto& path : listFiles(directory))
+	{
+		std::ifstream input(path, std::ios::binary);
+
+		if (!input)
+		{
+			std::cout << "ERROR::SHADER_BUNDLE::FILE_NOT_SUCCESSFULLY_READ " << path << std::endl;
+
+			return false;
+		}
+
+		files[path].assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+
+	std::vector<BundleEntry> entries;
+
+	entries.reserve(files.size());
+
+	std::string strings;
+
+	std::string data;
+
+	for (const auto& file : files)
+	{
+		BundleEntry entry;
+
+		entry.pathOffset = static_cast<uint32_t>(strings.size());
+
+		entry.pathLength = static_cast<uint32_t>(file.first.size());
+
+		entry.dataOffset = static_cast<uint32_t>(data.size());
+
+		entry.dataLength = static_cast<uint32_t>(file.second.size());
+
+		entries.push_back(entry);
+
+		strings += file.first;
+
+		data += file.second;
+	}
+
+	/* the path table follows the index, the file contents follow the path table */
+	const auto stringsStart = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+
+	const auto dataStart = stringsStart + strings.size();
+
+	for (auto& entry : entries)
+	{
+		entry.pathOffset += static_cast<uint32_t>(stringsStart);
+
+		entry.dataOffset += static_cast<uint32_t>(dataStart);
+	}
+
+	BundleHeader header = {BUNDLE_MAGIC, BUNDLE_VERSION, static_cast<uint32_t>(entries.size()), 0};
+
+	std::ofstream output(bundlePath, std::ios::binary | std::ios::trunc);
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BundleEntry));
+
+	output.write(strings.data(), strings.size());
+
+	output.write(data.data(), data.size());
+
+	if (!output)
+	{
+		std::cout << "ERROR::SHADER_BUNDLE::WRITE_FAILED " << bundlePath << std::endl;
+
+		return false;
+	}
+
+	std::cout << "Packed " << files.size() << " files (" << dataStart + data.size() << " bytes) into " << bundlePath <<
+		std::endl;
+
+	return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef SHADER_BUNDLE_H
+#define SHADER_BUNDLE_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+/*
+ * All shader sources packed into one file and memory mapped at startup, so loading a program doesn't open
+ * a file per stage and include. Lookups binary search the sorted index in place, nothing is parsed or copied on open.
+ * Paths are stored the way the shaders are referenced ("Shaders/include/pbr_brdf.glsl").
+ * Without a bundle (or for files it doesn't contain) Shader::readSource falls back to the loose files.
+ */
+class ShaderBundle
+{
+public:
+	/* maps a bundle, returns false if it is missing or malformed */
+	static bool open(const std::string& path);
+
+	static void close();
+
+	static bool isOpen();
+
+	/* points data at a file's contents inside the mapping (not null terminated), returns false if it isn't bundled */
+	static bool find(const std::string& path, const char*& data, size_t& size);
+
+	/* packs every file below a directory (plus generated entries) into a bundle, used by the build step (LearnOpenGL --pack-shaders) */
+	static bool pack(const std::string& directory, const std::string& bundlePath,
+	                 const std::map<std::string, std::string>& generated = std::map<std::string, std::string>());
+
+	/* paths of all files below a directory ("Shaders/include/pbr_brdf.glsl"), sorted */
+	static std::vector<std::string> listFiles(const std::string& directory);
+
+private:
+	static MappedFile file;
+};
+
+#endif
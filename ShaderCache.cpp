@@ -0,0 +1,222 @@
+#include "ShaderCache.h"
+#include "GLExtensions.h"
+#include "Hash.h"
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+	/* 'LGPB', bump the version whenever the file layout changes */
+	const uint32_t CACHE_MAGIC = 0x4250474C;
+
+	const uint32_t CACHE_VERSION = 1;
+
+	struct CacheHeader
+	{
+		uint32_t magic;
+
+		uint32_t version;
+
+		uint64_t key;
+
+		uint32_t format;
+
+		uint32_t length;
+	};
+
+	/* vendor, renderer and version of the current context, binaries are only valid for the exact same driver */
+	const std::string& driverString()
+	{
+		static std::string driver;
+
+		if (driver.empty())
+		{
+			for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+			{
+				const auto value = reinterpret_cast<const char*>(glGetString(name));
+
+				driver += value != nullptr ? value : "";
+
+				driver += '\n';
+			}
+		}
+
+		return driver;
+	}
+
+	void makeDirectory(const std::string& path)
+	{
+#ifdef _WIN32
+		_mkdir(path.c_str());
+#else
+		mkdir(path.c_str(), 0755);
+#endif
+	}
+}
+
+std::string ShaderCache::directory = "ShaderCache";
+
+bool ShaderCache::enabled = true;
+
+ShaderCacheStats ShaderCache::stats = {};
+
+uint64_t ShaderCache::makeKey(const std::string& vertexCode, const std::string& fragmentCode,
+                              const std::string& geometryCode, const std::string& defines)
+{
+	auto hash = hashBytes(&CACHE_VERSION, sizeof(CACHE_VERSION));
+
+	hash = hashString(vertexCode, hash);
+
+	hash = hashString(fragmentCode, hash);
+
+	hash = hashString(geometryCode, hash);
+
+	hash = hashString(defines, hash);
+
+	return hashString(driverString(), hash);
+}
+
+bool ShaderCache::isSupported()
+{
+	if (!GLEXT_ARB_get_program_binary)
+	{
+		return false;
+	}
+
+	/* some drivers expose the entry points without supporting a single format */
+	GLint formats = 0;
+
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+	return formats > 0;
+}
+
+void ShaderCache::prepare(const unsigned int program)
+{
+	if (enabled && isSupported())
+	{
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+}
+
+bool ShaderCache::load(const unsigned int program, const uint64_t key)
+{
+	if (!enabled || !isSupported())
+	{
+		return false;
+	}
+
+	const auto path = entryPath(key);
+
+	std::ifstream file(path, std::ios::binary);
+
+	CacheHeader header{};
+
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != CACHE_MAGIC ||
+		header.version != CACHE_VERSION || header.key != key)
+	{
+		++stats.misses;
+
+		return false;
+	}
+
+	std::vector<char> binary(header.length);
+
+	if (!file.read(binary.data(), binary.size()))
+	{
+		++stats.misses;
+
+		return false;
+	}
+
+	file.close();
+
+	glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+	GLint success = 0;
+
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+	if (!success)
+	{
+		/* the driver changed its binary format, drop the stale entry and compile from source */
+		std::remove(path.c_str());
+
+		++stats.rejected;
+
+		++stats.misses;
+
+		return false;
+	}
+
+	++stats.hits;
+
+	return true;
+}
+
+void ShaderCache::store(const unsigned int program, const uint64_t key)
+{
+	if (!enabled || !isSupported())
+	{
+		return;
+	}
+
+	GLint length = 0;
+
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> binary(static_cast<size_t>(length));
+
+	CacheHeader header{CACHE_MAGIC, CACHE_VERSION, key, 0, 0};
+
+	GLenum format = 0;
+
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	header.format = format;
+
+	header.length = static_cast<uint32_t>(length);
+
+	makeDirectory(directory);
+
+	std::ofstream file(entryPath(key), std::ios::binary | std::ios::trunc);
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	file.write(binary.data(), header.length);
+
+	if (file)
+	{
+		++stats.stored;
+	}
+}
+
+const ShaderCacheStats& ShaderCache::getStats()
+{
+	return stats;
+}
+
+void ShaderCache::resetStats()
+{
+	stats = {};
+}
+
+std::string ShaderCache::entryPath(const uint64_t key)
+{
+	char name[17];
+
+	std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+
+	return directory + '/' + name + ".bin";
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+
+/* counters of the program binary cache, reset by ShaderCache::resetStats */
+struct ShaderCacheStats
+{
+	/* programs restored from disk */
+	unsigned int hits;
+
+	/* programs without a usable binary, compiled from source */
+	unsigned int misses;
+
+	/* binaries found on disk but refused by the driver (driver update, different GPU) */
+	unsigned int rejected;
+
+	/* binaries written after a successful link */
+	unsigned int stored;
+};
+
+/*
+ * Persistent cache of linked program binaries (glGetProgramBinary/glProgramBinary).
+ * Entries are keyed by a hash of all stage sources, the injected defines and the driver string,
+ * so any source or driver change simply misses and the program is compiled from source again.
+ */
+class ShaderCache
+{
+public:
+	/* directory the binaries are stored in, created on first store */
+	static std::string directory;
+
+	/* set to false to always compile from source */
+	static bool enabled;
+
+	/* builds the cache key of a program */
+	static uint64_t makeKey(const std::string& vertexCode, const std::string& fragmentCode,
+	                        const std::string& geometryCode, const std::string& defines = std::string());
+
+	/* returns true if the context can save and restore program binaries */
+	static bool isSupported();
+
+	/* marks a program as retrievable, must be called before glLinkProgram */
+	static void prepare(unsigned int program);
+
+	/* restores a linked program from disk, returns false on a miss or if the driver refused the binary */
+	static bool load(unsigned int program, uint64_t key);
+
+	/* writes the binary of a successfully linked program to disk */
+	static void store(unsigned int program, uint64_t key);
+
+	static const ShaderCacheStats& getStats();
+
+	static void resetStats();
+
+private:
+	static ShaderCacheStats stats;
+
+	/* returns the file an entry is stored in */
+	static std::string entryPath(uint64_t key);
+};
+
+#endif
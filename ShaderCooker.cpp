@@ -0,0 +1,325 @@
+#include "ShaderCooker.h"
+#include "Shader.h"
+#include "ShaderBundle.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	struct ProgramDesc
+	{
+		std::string vertexPath;
+
+		std::string fragmentPath;
+
+		std::string geometryPath;
+
+		ShaderDefines defines;
+	};
+
+	bool endsWith(const std::string& text, const std::string& suffix)
+	{
+		return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+
+	/* <vertex> <fragment> [<geometry>] [NAME=VALUE ...] per line, # starts a comment */
+	bool readManifest(const std::string& path, std::vector<ProgramDesc>& programs)
+	{
+		std::ifstream manifest(path);
+
+		if (!manifest)
+		{
+			std::cout << "ERROR::SHADER_COOKER::MANIFEST_NOT_FOUND " << path << std::endl;
+
+			return false;
+		}
+
+		std::string line;
+
+		while (std::getline(manifest, line))
+		{
+			line = line.substr(0, line.find('#'));
+
+			std::istringstream tokens(line);
+
+			ProgramDesc program;
+
+			std::string token;
+
+			while (tokens >> token)
+			{
+				const auto equals = token.find('=');
+
+				if (equals != std::string::npos)
+				{
+					program.defines[token.substr(0, equals)] = token.substr(equals + 1);
+				}
+				else if (program.vertexPath.empty())
+				{
+					program.vertexPath = token;
+				}
+				else if (program.fragmentPath.empty())
+				{
+					program.fragmentPath = token;
+				}
+				else
+				{
+					program.geometryPath = token;
+				}
+			}
+
+			if (!program.vertexPath.empty())
+			{
+				programs.push_back(program);
+			}
+		}
+
+		return true;
+	}
+}
+
+bool ShaderCooker::cook(const std::string& directory, const std::string& manifestPath, const std::string& bundlePath)
+{
+	const auto files = ShaderBundle::listFiles(directory);
+
+	std::vector<ProgramDesc> programs;
+
+	/* X.vs + X.fs (+ X.gs) is a program by convention */
+	for (const auto& file : files)
+	{
+		if (!endsWith(file, ".vs"))
+		{
+			continue;
+		}
+
+		const auto stem = file.substr(0, file.size() - 3);
+
+		if (!std::binary_search(files.begin(), files.end(), stem + ".fs"))
+		{
+			continue;
+		}
+
+		ProgramDesc program;
+
+		program.vertexPath = file;
+
+		program.fragmentPath = stem + ".fs";
+
+		if (std::binary_search(files.begin(), files.end(), stem + ".gs"))
+		{
+			program.geometryPath = stem + ".gs";
+		}
+
+		programs.push_back(program);
+	}
+
+	if (!readManifest(manifestPath, programs))
+	{
+		return false;
+	}
+
+	std::map<std::string, std::string> cooked;
+
+	auto failed = 0u;
+
+	size_t expandedBytes = 0;
+
+	size_t cookedBytes = 0;
+
+	for (const auto& program : programs)
+	{
+		std::string codes[3];
+
+		const std::string* paths[3] = {&program.vertexPath, &program.fragmentPath, &program.geometryPath};
+
+		auto success = true;
+
+		for (auto stage = 0; stage < 3 && success; ++stage)
+		{
+			if (paths[stage]->empty())
+			{
+				continue;
+			}
+
+			std::string code;
+
+			success = ShaderPreprocessor::process(*paths[stage], program.defines, code);
+
+			expandedBytes += code.size();
+
+			codes[stage] = strip(code);
+		}
+
+		/* validate exactly what ships */
+		success = success && validate(codes[0], codes[1], codes[2]);
+
+		if (!success)
+		{
+			std::cout << "ERROR::SHADER_COOKER::PROGRAM_FAILED " << program.vertexPath << " " << program.fragmentPath <<
+				" " << program.geometryPath << " " << ShaderPreprocessor::definesKey(program.defines) << std::endl;
+
+			++failed;
+
+			continue;
+		}
+
+		for (auto stage = 0; stage < 3; ++stage)
+		{
+			if (!paths[stage]->empty())
+			{
+				cooked[ShaderPreprocessor::cookedPath(*paths[stage], program.defines)] = codes[stage];
+			}
+		}
+	}
+
+	for (const auto& stage : cooked)
+	{
+		cookedBytes += stage.second.size();
+	}
+
+	std::cout << "Cooked " << programs.size() - failed << "/" << programs.size() << " programs, " << cooked.size() <<
+		" stage variants, stripped " << expandedBytes << " -> " << cookedBytes << " bytes" << std::endl;
+
+	return failed == 0 && ShaderBundle::pack(directory, bundlePath, cooked);
+}
+
+std::string ShaderCooker::strip(const std::string& code)
+{
+	/* drop comments, keeping the line breaks inside block comments */
+	std::string uncommented;
+
+	uncommented.reserve(code.size());
+
+	for (size_t i = 0; i < code.size(); ++i)
+	{
+		if (code.compare(i, 2, "//") == 0)
+		{
+			while (i < code.size() && code[i] != '\n')
+			{
+				++i;
+			}
+		}
+		else if (code.compare(i, 2, "/*") == 0)
+		{
+			const auto end = code.find("*/", i + 2);
+
+			const auto last = end == std::string::npos ? code.size() : end + 2;
+
+			uncommented.append(static_cast<size_t>(std::count(code.begin() + i, code.begin() + last, '\n')), '\n');
+
+			/* a comment between two tokens still separates them */
+			uncommented += ' ';
+
+			i = last - 1;
+
+			continue;
+		}
+
+		if (i < code.size())
+		{
+			uncommented += code[i];
+		}
+	}
+
+	/* trim every line */
+	std::string stripped;
+
+	stripped.reserve(uncommented.size());
+
+	size_t lineStart = 0;
+
+	while (lineStart < uncommented.size())
+	{
+		auto lineEnd = uncommented.find('\n', lineStart);
+
+		if (lineEnd == std::string::npos)
+		{
+			lineEnd = uncommented.size();
+		}
+
+		const auto first = uncommented.find_first_not_of(" \t\r", lineStart);
+
+		if (first < lineEnd)
+		{
+			const auto last = uncommented.find_last_not_of(" \t\r", lineEnd - 1);
+
+			stripped.append(uncommented, first, last - first + 1);
+		}
+
+		stripped += '\n';
+
+		lineStart = lineEnd + 1;
+	}
+
+	return stripped;
+}
+
+bool ShaderCooker::validate(const std::string& vertexCode, const std::string& fragmentCode,
+                            const std::string& geometryCode)
+{
+	struct Stage
+	{
+		GLenum type;
+
+		const std::string* code;
+
+		const char* typeName;
+	};
+
+	const Stage stages[] = {
+		{GL_VERTEX_SHADER, &vertexCode, "VERTEX"},
+		{GL_FRAGMENT_SHADER, &fragmentCode, "FRAGMENT"},
+		{GL_GEOMETRY_SHADER, &geometryCode, "GEOMETRY"}
+	};
+
+	std::vector<unsigned int> shaders;
+
+	auto success = true;
+
+	for (const auto& stage : stages)
+	{
+		if (stage.code->empty())
+		{
+			continue;
+		}
+
+		const auto code = stage.code->c_str();
+
+		const auto shader = glCreateShader(stage.type);
+
+		glShaderSource(shader, 1, &code, nullptr);
+
+		glCompileShader(shader);
+
+		success = Shader::checkCompileErrors(shader, stage.typeName) && success;
+
+		shaders.push_back(shader);
+	}
+
+	const auto program = glCreateProgram();
+
+	for (const auto shader : shaders)
+	{
+		glAttachShader(program, shader);
+	}
+
+	if (success)
+	{
+		glLinkProgram(program);
+
+		success = Shader::checkCompileErrors(program, "PROGRAM");
+	}
+
+	for (const auto shader : shaders)
+	{
+		glDeleteShader(shader);
+	}
+
+	glDeleteProgram(program);
+
+	return success;
+}
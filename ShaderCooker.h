@@ -0,0 +1,32 @@
+#pragma once
+
+#ifndef SHADER_COOKER_H
+#define SHADER_COOKER_H
+
+#include <string>
+#include "ShaderPreprocessor.h"
+
+/*
+ * Release build step that validates and packs every program (LearnOpenGL --cook-shaders): expands includes and
+ * defines for each permutation, compiles and links it so broken shaders fail the build instead of the first run,
+ * strips comments and indentation and stores the result next to the loose files in the shader bundle. The code
+ * isn't transformed beyond that, optimising it is left to the driver. The preprocessor picks a cooked stage straight
+ * from the bundle, so release builds neither expand includes nor parse comments at startup. Without a GL context
+ * the step fails, build machines without one have to opt into an unvalidated pack (/p:PackShadersUnvalidated=true).
+ */
+class ShaderCooker
+{
+public:
+	/* cooks the programs found in directory plus the ones listed in the manifest, requires a current GL context */
+	static bool cook(const std::string& directory, const std::string& manifestPath, const std::string& bundlePath);
+
+	/* removes comments and leading/trailing white space, line numbers stay the same */
+	static std::string strip(const std::string& code);
+
+private:
+	/* builds a program from expanded sources, reports every compile or link error */
+	static bool validate(const std::string& vertexCode, const std::string& fragmentCode,
+	                     const std::string& geometryCode);
+};
+
+#endif
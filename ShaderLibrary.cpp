@@ -0,0 +1,231 @@
+#include "ShaderLibrary.h"
+#include "GLExtensions.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <thread>
+
+ShaderLibrary::ShaderLibrary(ThreadPool& pool) : pool(pool)
+{
+	/* let the driver compile on as many threads as it likes */
+	if (GLEXT_KHR_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreads(0xFFFFFFFF);
+	}
+
+	/* compiled up front and blocking, it is drawn whenever a program isn't ready */
+	fallback.reset(new Shader("Shaders/fallback.vs", "Shaders/fallback.fs"));
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+	for (auto& pair : entries)
+	{
+		auto& entry = pair.second;
+
+		/* a reader may still be running, it only touches its own future */
+		if (entry.sources.valid())
+		{
+			entry.sources.wait();
+		}
+	}
+
+	glDeleteProgram(fallback->ID);
+}
+
+void ShaderLibrary::add(const std::string& name, const std::string& vertexPath, const std::string& fragmentPath,
+                        const std::string& geometryPath, const ShaderDefines& defines)
+{
+	if (names.find(name) != names.end())
+	{
+		std::cout << "ERROR::SHADER_LIBRARY::DUPLICATE_PROGRAM " << name << std::endl;
+
+		return;
+	}
+
+	const auto key = ShaderPreprocessor::variantKey(vertexPath, fragmentPath, geometryPath, defines);
+
+	names[name] = key;
+
+	/* an identical permutation was already requested, share its program */
+	if (entries.find(key) != entries.end())
+	{
+		return;
+	}
+
+	auto& entry = entries[key];
+
+	entry.name = name;
+
+	entry.definesKey = ShaderPreprocessor::definesKey(defines);
+
+	entry.sources = pool.submit([vertexPath, fragmentPath, geometryPath, defines]()
+	{
+		Sources sources;
+
+		sources.valid = ShaderPreprocessor::process(vertexPath, defines, sources.vertexCode) &&
+			ShaderPreprocessor::process(fragmentPath, defines, sources.fragmentCode) &&
+			(geometryPath.empty() || ShaderPreprocessor::process(geometryPath, defines, sources.geometryCode));
+
+		return sources;
+	});
+
+	++pending;
+}
+
+void ShaderLibrary::update()
+{
+	if (pending == 0)
+	{
+		return;
+	}
+
+	/* 1. submit every program whose sources have arrived, the driver can work on all of them at once */
+	for (auto& pair : entries)
+	{
+		auto& entry = pair.second;
+
+		if (entry.state == State::Reading &&
+			entry.sources.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			submit(entry);
+		}
+	}
+
+	/* 2. publish finished programs without stalling on the ones still in flight */
+	auto blockingBudget = blockingLinksPerUpdate;
+
+	for (auto& pair : entries)
+	{
+		auto& entry = pair.second;
+
+		if (entry.state != State::Linking)
+		{
+			continue;
+		}
+
+		if (GLEXT_KHR_parallel_shader_compile)
+		{
+			if (entry.build.isComplete())
+			{
+				complete(entry);
+			}
+		}
+		else if (blockingBudget > 0)
+		{
+			--blockingBudget;
+
+			complete(entry);
+		}
+	}
+}
+
+void ShaderLibrary::finish()
+{
+	const auto budget = blockingLinksPerUpdate;
+
+	blockingLinksPerUpdate = static_cast<unsigned int>(entries.size());
+
+	while (pending > 0)
+	{
+		update();
+
+		std::this_thread::yield();
+	}
+
+	blockingLinksPerUpdate = budget;
+}
+
+bool ShaderLibrary::isReady(const std::string& name) const
+{
+	const auto entry = find(name);
+
+	return entry != nullptr && entry->state == State::Ready;
+}
+
+bool ShaderLibrary::isIdle() const
+{
+	return pending == 0;
+}
+
+const Shader& ShaderLibrary::get(const std::string& name) const
+{
+	const auto entry = find(name);
+
+	if (entry == nullptr || entry->state != State::Ready)
+	{
+		return *fallback;
+	}
+
+	return *entry->shader;
+}
+
+const Shader& ShaderLibrary::getFallback() const
+{
+	return *fallback;
+}
+
+size_t ShaderLibrary::getVariantCount() const
+{
+	return entries.size();
+}
+
+const ShaderLibrary::Entry* ShaderLibrary::find(const std::string& name) const
+{
+	const auto key = names.find(name);
+
+	if (key == names.end())
+	{
+		return nullptr;
+	}
+
+	const auto entry = entries.find(key->second);
+
+	return entry != entries.end() ? &entry->second : nullptr;
+}
+
+void ShaderLibrary::submit(Entry& entry)
+{
+	const auto sources = entry.sources.get();
+
+	if (!sources.valid)
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ " << entry.name << std::endl;
+
+		entry.state = State::Failed;
+
+		--pending;
+
+		return;
+	}
+
+	if (entry.build.submit(sources.vertexCode, sources.fragmentCode, sources.geometryCode, entry.definesKey))
+	{
+		entry.shader.reset(new Shader(entry.build.getProgram()));
+
+		entry.state = State::Ready;
+
+		--pending;
+
+		return;
+	}
+
+	entry.state = State::Linking;
+}
+
+void ShaderLibrary::complete(Entry& entry)
+{
+	--pending;
+
+	if (!entry.build.finish())
+	{
+		std::cout << "ERROR::SHADER_LIBRARY::PROGRAM_FAILED " << entry.name << ", using fallback" << std::endl;
+
+		entry.state = State::Failed;
+
+		return;
+	}
+
+	entry.shader.reset(new Shader(entry.build.getProgram()));
+
+	entry.state = State::Ready;
+}
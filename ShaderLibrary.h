@@ -0,0 +1,122 @@
+#pragma once
+
+#ifndef SHADER_LIBRARY_H
+#define SHADER_LIBRARY_H
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "ProgramBuild.h"
+#include "Shader.h"
+
+class ThreadPool;
+
+/*
+ * Builds programs without blocking the render loop.
+ * Sources are read on worker threads, all compiles and links are submitted as soon as the sources arrive
+ * and link status is only queried once the driver reports completion (GL_KHR_parallel_shader_compile).
+ * Until a program is ready, get() returns a fallback program that draws Mesh geometry in flat magenta
+ * (Shaders/fallback.vs).
+ * Programs are built per variant (stage paths + define set), names asking for an identical variant share one program.
+ */
+class ShaderLibrary
+{
+public:
+	/* without the parallel compile extension, status queries block, so only this many programs are finished per update */
+	unsigned int blockingLinksPerUpdate = 1;
+
+	/* compiles the fallback program, requires a current GL context */
+	explicit ShaderLibrary(ThreadPool& pool);
+
+	~ShaderLibrary();
+
+	ShaderLibrary(const ShaderLibrary&) = delete;
+
+	ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+	/* queues a program, reading and preprocessing its sources starts immediately on a worker thread */
+	void add(const std::string& name, const std::string& vertexPath, const std::string& fragmentPath,
+	         const std::string& geometryPath = std::string(), const ShaderDefines& defines = ShaderDefines());
+
+	/* advances all pending programs, call once per frame on the GL thread */
+	void update();
+
+	/* keeps updating until every program is either ready or failed (loading screens, tools) */
+	void finish();
+
+	/* returns true once the named program is linked and usable */
+	bool isReady(const std::string& name) const;
+
+	/* returns true if no program is pending */
+	bool isIdle() const;
+
+	/* returns the named program, or the fallback program while it is pending, failed or unknown */
+	const Shader& get(const std::string& name) const;
+
+	const Shader& getFallback() const;
+
+	/* number of distinct programs, lower than the number of names when variants are shared */
+	size_t getVariantCount() const;
+
+private:
+	enum class State
+	{
+		Reading,
+		Linking,
+		Ready,
+		Failed
+	};
+
+	struct Sources
+	{
+		bool valid = false;
+
+		std::string vertexCode;
+
+		std::string fragmentCode;
+
+		std::string geometryCode;
+	};
+
+	struct Entry
+	{
+		State state = State::Reading;
+
+		/* first name the variant was requested under, used in messages */
+		std::string name;
+
+		std::future<Sources> sources;
+
+		std::string definesKey;
+
+		ProgramBuild build;
+
+		std::unique_ptr<Shader> shader;
+	};
+
+	ThreadPool& pool;
+
+	/* program variants keyed by ShaderPreprocessor::variantKey */
+	std::unordered_map<uint64_t, Entry> entries;
+
+	/* name -> variant key */
+	std::unordered_map<std::string, uint64_t> names;
+
+	std::unique_ptr<Shader> fallback;
+
+	/* number of entries in the Reading or Linking state */
+	unsigned int pending = 0;
+
+	/* turns read sources into a program, restoring it from the binary cache when possible */
+	void submit(Entry& entry);
+
+	/* checks the results of a completed link and publishes the program */
+	void complete(Entry& entry);
+
+	/* returns the variant registered under a name, nullptr if there is none */
+	const Entry* find(const std::string& name) const;
+};
+
+#endif
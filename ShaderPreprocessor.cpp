@@ -0,0 +1,246 @@
+#include "ShaderPreprocessor.h"
+#include "Hash.h"
+#include "Shader.h"
+#include "ShaderBundle.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	std::string directoryOf(const std::string& path)
+	{
+		const auto slash = path.find_last_of("/\\");
+
+		return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+	}
+
+	/* returns true if the line is the given directive, ignoring leading white space */
+	bool isDirective(const std::string& line, const char* directive, size_t& end)
+	{
+		const auto start = line.find_first_not_of(" \t");
+
+		if (start == std::string::npos || line.compare(start, std::char_traits<char>::length(directive), directive) != 0)
+		{
+			return false;
+		}
+
+		end = start + std::char_traits<char>::length(directive);
+
+		return true;
+	}
+}
+
+bool ShaderPreprocessor::process(const std::string& path, const ShaderDefines& defines, std::string& code,
+                                 std::vector<std::string>* includes)
+{
+	/* the cooker already expanded and validated this variant */
+	if (ShaderBundle::isOpen())
+	{
+		const char* cooked;
+
+		size_t cookedSize;
+
+		if (ShaderBundle::find(cookedPath(path, defines), cooked, cookedSize))
+		{
+			code.assign(cooked, cookedSize);
+
+			if (includes != nullptr)
+			{
+				includes->clear();
+			}
+
+			return true;
+		}
+	}
+
+	/* points into the shader bundle when the file is bundled, storage only holds loose files */
+	const char* source;
+
+	size_t sourceSize;
+
+	std::string storage;
+
+	if (!Shader::readSource(path.c_str(), source, sourceSize, storage))
+	{
+		return false;
+	}
+
+	std::vector<std::string> included;
+
+	std::string body;
+
+	if (!expand(path, source, sourceSize, 0, included, body))
+	{
+		return false;
+	}
+
+	/* the #version directive has to stay first, the defines go right behind it */
+	std::string version;
+
+	size_t bodyStart = 0;
+
+	size_t directiveEnd;
+
+	const auto firstLineEnd = body.find('\n');
+
+	const auto firstLine = body.substr(0, firstLineEnd);
+
+	if (isDirective(firstLine, "#version", directiveEnd))
+	{
+		version = firstLine + '\n';
+
+		bodyStart = firstLineEnd == std::string::npos ? body.size() : firstLineEnd + 1;
+	}
+
+	code.clear();
+
+	code.reserve(body.size() + defines.size() * 32 + 32);
+
+	code += version;
+
+	for (const auto& define : defines)
+	{
+		code += "#define " + define.first + ' ' + define.second + '\n';
+	}
+
+	if (!defines.empty())
+	{
+		code += "#line " + std::to_string(version.empty() ? 1 : 2) + " 0\n";
+	}
+
+	code.append(body, bodyStart, std::string::npos);
+
+	if (includes != nullptr)
+	{
+		*includes = std::move(included);
+	}
+
+	return true;
+}
+
+std::string ShaderPreprocessor::definesKey(const ShaderDefines& defines)
+{
+	std::string key;
+
+	for (const auto& define : defines)
+	{
+		key += define.first + '=' + define.second + ';';
+	}
+
+	return key;
+}
+
+uint64_t ShaderPreprocessor::variantKey(const std::string& vertexPath, const std::string& fragmentPath,
+                                        const std::string& geometryPath, const ShaderDefines& defines)
+{
+	auto hash = hashString(vertexPath);
+
+	hash = hashString(fragmentPath, hash);
+
+	hash = hashString(geometryPath, hash);
+
+	return hashString(definesKey(defines), hash);
+}
+
+std::string ShaderPreprocessor::cookedPath(const std::string& path, const ShaderDefines& defines)
+{
+	return path + '?' + definesKey(defines);
+}
+
+bool ShaderPreprocessor::expand(const std::string& path, const char* source, const size_t sourceSize,
+                                const int sourceNumber, std::vector<std::string>& includes, std::string& code)
+{
+	const auto directory = directoryOf(path);
+
+	auto lineNumber = 0;
+
+	size_t lineStart = 0;
+
+	while (lineStart < sourceSize)
+	{
+		const auto newLine = static_cast<const char*>(std::memchr(source + lineStart, '\n', sourceSize - lineStart));
+
+		const auto lineEnd = newLine != nullptr ? static_cast<size_t>(newLine - source) : sourceSize;
+
+		const std::string line(source + lineStart, lineEnd - lineStart);
+
+		lineStart = lineEnd + 1;
+
+		++lineNumber;
+
+		size_t directiveEnd;
+
+		/* only the stage file itself may declare the version */
+		if (sourceNumber != 0 && isDirective(line, "#version", directiveEnd))
+		{
+			code += '\n';
+
+			continue;
+		}
+
+		/* files are included at most once anyway */
+		if (isDirective(line, "#pragma once", directiveEnd))
+		{
+			code += '\n';
+
+			continue;
+		}
+
+		if (!isDirective(line, "#include", directiveEnd))
+		{
+			code += line;
+
+			code += '\n';
+
+			continue;
+		}
+
+		const auto nameStart = line.find('"', directiveEnd);
+
+		const auto nameEnd = nameStart == std::string::npos ? nameStart : line.find('"', nameStart + 1);
+
+		if (nameEnd == std::string::npos)
+		{
+			std::cout << "ERROR::SHADER::MALFORMED_INCLUDE " << path << "(" << lineNumber << "): " << line << std::endl;
+
+			return false;
+		}
+
+		const auto includePath = directory + line.substr(nameStart + 1, nameEnd - nameStart - 1);
+
+		if (std::find(includes.begin(), includes.end(), includePath) != includes.end())
+		{
+			code += '\n';
+
+			continue;
+		}
+
+		const char* includeSource;
+
+		size_t includeSize;
+
+		std::string includeStorage;
+
+		if (!Shader::readSource(includePath.c_str(), includeSource, includeSize, includeStorage))
+		{
+			std::cout << "ERROR::SHADER::INCLUDE_NOT_FOUND " << includePath << " included from " << path << std::endl;
+
+			return false;
+		}
+
+		includes.push_back(includePath);
+
+		code += "#line 1 " + std::to_string(includes.size()) + '\n';
+
+		if (!expand(includePath, includeSource, includeSize, static_cast<int>(includes.size()), includes, code))
+		{
+			return false;
+		}
+
+		/* continue with the line after the #include */
+		code += "#line " + std::to_string(lineNumber + 1) + ' ' + std::to_string(sourceNumber) + '\n';
+	}
+
+	return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/* NAME -> VALUE pairs injected as #define lines, ordered so that equal sets always produce the same text and key */
+typedef std::map<std::string, std::string> ShaderDefines;
+
+/*
+ * Expands #include "file" directives (relative to the including file, every file is included at most once per stage)
+ * and injects a define set right after the #version line, so one source can be specialised into several variants.
+ * #line directives keep compiler messages pointing at the right file: source string 0 is the stage file itself,
+ * string N is the Nth entry of the returned include list.
+ */
+class ShaderPreprocessor
+{
+public:
+	/* reads and expands a stage, returns false if the stage or one of its includes can't be read */
+	static bool process(const std::string& path, const ShaderDefines& defines, std::string& code,
+	                    std::vector<std::string>* includes = nullptr);
+
+	/* canonical text of a define set ("A=1;B=0;"), part of every cache and variant key */
+	static std::string definesKey(const ShaderDefines& defines);
+
+	/* identifies a program variant by its stage paths and define set */
+	static uint64_t variantKey(const std::string& vertexPath, const std::string& fragmentPath,
+	                           const std::string& geometryPath, const ShaderDefines& defines);
+
+	/* bundle path of a stage variant stored by ShaderCooker, process() looks it up before expanding the source */
+	static std::string cookedPath(const std::string& path, const ShaderDefines& defines);
+
+private:
+	static bool expand(const std::string& path, const char* source, size_t sourceSize, int sourceNumber,
+	                   std::vector<std::string>& includes, std::string& code);
+};
+
+#endif
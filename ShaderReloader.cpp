@@ -0,0 +1,228 @@
+#include "ShaderReloader.h"
+#include "GLExtensions.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+
+ShaderReloader::ShaderReloader(ThreadPool& pool) : pool(pool)
+{
+}
+
+ShaderReloader::~ShaderReloader()
+{
+	for (auto& entry : entries)
+	{
+		/* a reader may still be running, it only touches its own future */
+		if (entry.sources.valid())
+		{
+			entry.sources.wait();
+		}
+	}
+}
+
+void ShaderReloader::watch(Shader& shader, const std::string& vertexPath, const std::string& fragmentPath,
+                           const std::string& geometryPath, const ShaderDefines& defines)
+{
+	entries.emplace_back();
+
+	auto& entry = entries.back();
+
+	entry.shader = &shader;
+
+	entry.vertexPath = vertexPath;
+
+	entry.fragmentPath = fragmentPath;
+
+	entry.geometryPath = geometryPath;
+
+	entry.defines = defines;
+
+	/* the include list is only known once the sources were expanded */
+	read(entry);
+
+	entry.state = State::Scanning;
+}
+
+unsigned int ShaderReloader::update()
+{
+	for (const auto& path : watcher.poll())
+	{
+		for (auto& entry : entries)
+		{
+			if (std::find(entry.dependencies.begin(), entry.dependencies.end(), path) == entry.dependencies.end())
+			{
+				continue;
+			}
+
+			if (entry.state == State::Idle)
+			{
+				read(entry);
+			}
+			else
+			{
+				entry.stale = true;
+			}
+		}
+	}
+
+	auto swapped = 0u;
+
+	/* without the parallel compile extension a status query blocks, so finish at most one program per frame */
+	auto blockingLinks = 1u;
+
+	for (auto& entry : entries)
+	{
+		const auto sourcesReady = entry.sources.valid() &&
+			entry.sources.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+
+		if ((entry.state == State::Scanning || entry.state == State::Reading) && sourcesReady)
+		{
+			auto sources = entry.sources.get();
+
+			/* keep watching the stage files of a broken program, the next save may fix it */
+			if (!sources.dependencies.empty())
+			{
+				entry.dependencies = sources.dependencies;
+			}
+
+			for (const auto& dependency : entry.dependencies)
+			{
+				watcher.watch(dependency);
+			}
+
+			if (entry.state == State::Scanning)
+			{
+				entry.state = State::Idle;
+			}
+			else if (!sources.valid)
+			{
+				std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ " << entry.fragmentPath << std::endl;
+
+				entry.state = State::Idle;
+			}
+			else
+			{
+				/* reverting an edit finds the earlier binary, it still completes through the Linking state */
+				entry.build.submit(sources.vertexCode, sources.fragmentCode, sources.geometryCode,
+				                   ShaderPreprocessor::definesKey(entry.defines));
+
+				entry.state = State::Linking;
+			}
+		}
+
+		if (entry.state == State::Linking)
+		{
+			auto linked = false;
+
+			if (GLEXT_KHR_parallel_shader_compile)
+			{
+				linked = entry.build.isComplete();
+			}
+			else if (blockingLinks > 0)
+			{
+				--blockingLinks;
+
+				linked = true;
+			}
+
+			if (linked && complete(entry))
+			{
+				++swapped;
+			}
+		}
+
+		if (entry.state == State::Idle && entry.stale)
+		{
+			entry.stale = false;
+
+			read(entry);
+		}
+	}
+
+	return swapped;
+}
+
+void ShaderReloader::read(Entry& entry)
+{
+	const auto vertexPath = entry.vertexPath;
+
+	const auto fragmentPath = entry.fragmentPath;
+
+	const auto geometryPath = entry.geometryPath;
+
+	const auto defines = entry.defines;
+
+	entry.state = State::Reading;
+
+	entry.sources = pool.submit([vertexPath, fragmentPath, geometryPath, defines]()
+	{
+		Sources sources;
+
+		std::vector<std::string> includes;
+
+		sources.valid = true;
+
+		for (const auto& stage : {
+			     std::make_pair(&vertexPath, &sources.vertexCode),
+			     std::make_pair(&fragmentPath, &sources.fragmentCode),
+			     std::make_pair(&geometryPath, &sources.geometryCode)
+		     })
+		{
+			if (stage.first->empty())
+			{
+				continue;
+			}
+
+			sources.dependencies.push_back(*stage.first);
+
+			if (!ShaderPreprocessor::process(*stage.first, defines, *stage.second, &includes))
+			{
+				sources.valid = false;
+
+				continue;
+			}
+
+			for (const auto& include : includes)
+			{
+				if (std::find(sources.dependencies.begin(), sources.dependencies.end(), include) ==
+					sources.dependencies.end())
+				{
+					sources.dependencies.push_back(include);
+				}
+			}
+		}
+
+		return sources;
+	});
+}
+
+bool ShaderReloader::complete(Entry& entry)
+{
+	entry.state = State::Idle;
+
+	if (!entry.build.finish())
+	{
+		std::cout << "ERROR::SHADER_RELOADER::RELOAD_FAILED " << entry.fragmentPath << ", keeping the previous program" <<
+			std::endl;
+
+		return false;
+	}
+
+	swap(entry);
+
+	return true;
+}
+
+void ShaderReloader::swap(Entry& entry)
+{
+	Shader reloaded(entry.build.release());
+
+	/* the copied values are uploaded by the next flush */
+	reloaded.copyUniformValues(*entry.shader);
+
+	const auto previous = entry.shader->ID;
+
+	*entry.shader = std::move(reloaded);
+
+	glDeleteProgram(previous);
+}
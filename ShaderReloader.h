@@ -0,0 +1,106 @@
+#pragma once
+
+#ifndef SHADER_RELOADER_H
+#define SHADER_RELOADER_H
+
+#include <future>
+#include <string>
+#include <vector>
+#include "FileWatcher.h"
+#include "ProgramBuild.h"
+#include "Shader.h"
+
+class ThreadPool;
+
+/*
+ * Rebuilds watched programs when one of their stage files or includes is saved.
+ * Sources are read on worker threads and compiled without blocking (GL_KHR_parallel_shader_compile when present),
+ * the new program only replaces the live Shader's ID once it linked. Values of uniforms that survive the edit
+ * (same name and type) are taken over from the old program's uniform copy, so nothing has to be set again.
+ * A failed compile keeps the old program running.
+ */
+class ShaderReloader
+{
+public:
+	explicit ShaderReloader(ThreadPool& pool);
+
+	~ShaderReloader();
+
+	ShaderReloader(const ShaderReloader&) = delete;
+
+	ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+	/* starts watching the sources the shader was built from, the shader must outlive the reloader */
+	void watch(Shader& shader, const std::string& vertexPath, const std::string& fragmentPath,
+	           const std::string& geometryPath = std::string(), const ShaderDefines& defines = ShaderDefines());
+
+	/*
+	 * advances pending reloads, call once per frame on the GL thread before drawing.
+	 * returns the number of programs swapped, UniformHandles fetched from those shaders are stale afterwards.
+	 */
+	unsigned int update();
+
+private:
+	enum class State
+	{
+		/* first read of the sources, only collects the include list */
+		Scanning,
+		Idle,
+		Reading,
+		Linking
+	};
+
+	struct Sources
+	{
+		bool valid = false;
+
+		std::string vertexCode;
+
+		std::string fragmentCode;
+
+		std::string geometryCode;
+
+		/* every file the stages were built from, including the stage files themselves */
+		std::vector<std::string> dependencies;
+	};
+
+	struct Entry
+	{
+		State state = State::Scanning;
+
+		Shader* shader = nullptr;
+
+		std::string vertexPath;
+
+		std::string fragmentPath;
+
+		std::string geometryPath;
+
+		ShaderDefines defines;
+
+		std::vector<std::string> dependencies;
+
+		/* a file changed again while this entry was already being rebuilt */
+		bool stale = false;
+
+		std::future<Sources> sources;
+
+		ProgramBuild build;
+	};
+
+	ThreadPool& pool;
+
+	FileWatcher watcher;
+
+	std::vector<Entry> entries;
+
+	/* reads and preprocesses the entry's sources on a worker thread */
+	void read(Entry& entry);
+
+	/* checks a completed link, swaps the program in on success, returns true if it was swapped */
+	bool complete(Entry& entry);
+
+	void swap(Entry& entry);
+};
+
+#endif
@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 1) in vec2 aTexCoords;
@@ -8,10 +10,6 @@ out vec2 TexCoords;
 
 uniform mat4 model;
 
-uniform mat4 view;
-
-uniform mat4 projection;
-
 void main()
 {
     TexCoords = aTexCoords;
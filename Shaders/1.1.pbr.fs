@@ -1,5 +1,9 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
+#include "include/light_uniforms.glsl"
+
 out vec4 FragColor;
 
 in vec2 TexCoords;
@@ -17,13 +21,6 @@ uniform float roughness;
 
 uniform float ao;
 
-/* lights */
-uniform vec3 lightPositions[4];
-
-uniform vec3 lightColors[4];
-
-uniform vec3 cameraPos;
-
 const float PI = 3.14159265359f;
 
 /******************************/
@@ -82,7 +79,7 @@ void main()
 {
 	vec3 N = normalize(Normal);
 	
-	vec3 V = normalize(cameraPos - WorldPos);
+	vec3 V = normalize(viewPos - WorldPos);
 	
 	/* calculate reflectance at normal incidence; */
 	/* if dia-electric (like plastic) use F of 0.04 and if it's a metal, */
@@ -94,18 +91,18 @@ void main()
 	/* reflectance equation */
 	vec3 Lo = vec3(0.f);
 	
-	for (int i = 0;i < 4; ++i)
+	for (int i = 0; i < lightCount; ++i)
 	{
 		/* calculate per-light radiance */
-		vec3 L = normalize(lightPositions[i] - WorldPos);
+		vec3 L = normalize(lights[i].Position - WorldPos);
 		
 		vec3 H = normalize(V + L);
 		
-		float distance = length(lightPositions[i] - WorldPos);
+		float distance = length(lights[i].Position - WorldPos);
 		
 		float attenuation = 1.f / (distance * distance);
 		
-		vec3 radiance = lightColors[i] * attenuation;
+		vec3 radiance = lights[i].Color * attenuation;
 		
 		/* Cook-Torrance BRDF */
 		float NDF = DistributionGGX(N, H, roughness);
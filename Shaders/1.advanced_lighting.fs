@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 out vec4 FragColor;
 
 in VS_OUT {
@@ -14,8 +16,6 @@ uniform sampler2D floorTexture;
 
 uniform vec3 lightPos;
 
-uniform vec3 viewPos;
-
 uniform bool blinn;
 
 void main()
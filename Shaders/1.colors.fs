@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 out vec4 FragColor;
 
 struct Material {
@@ -66,8 +68,6 @@ in vec3 Normal;
 
 in vec2 TexCoords;
 
-uniform vec3 viewPos;
-
 uniform DirLight dirLight;
 
 uniform PointLight pointLights[NR_POINT_LIGHTS];
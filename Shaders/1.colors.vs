@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 1) in vec3 aNormal;
@@ -14,10 +16,6 @@ out vec2 TexCoords;
 
 uniform mat4 model;
 
-uniform mat4 view;
-
-uniform mat4 projection;
-
 void main()
 {
 	FragPos = vec3(model * vec4(aPos, 1.f));
@@ -1,13 +1,11 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 uniform mat4 model;
 
-uniform mat4 view;
-
-uniform mat4 projection;
-
 void main()
 {
 	gl_Position = projection * view * model * vec4(aPos, 1.f);
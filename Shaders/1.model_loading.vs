@@ -1,22 +1,21 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+#include "include/frame_uniforms.glsl"
 
-layout (location = 1) in vec3 aNormal;
+/* only ever draws Mesh geometry, which is uploaded packed */
+#ifndef PACKED_VERTEX
+#define PACKED_VERTEX 1
+#endif
 
-layout (location = 2) in vec2 aTexCoords;
+#include "include/mesh_vertex.glsl"
 
 out vec2 TexCoords;
 
 uniform mat4 model;
 
-uniform mat4 view;
-
-uniform mat4 projection;
-
 void main()
 {
     TexCoords = aTexCoords;
     
-    gl_Position = projection * view * model * vec4(aPos, 1.f);
+    gl_Position = projection * view * model * vec4(vertexPosition(), 1.f);
 }
\ No newline at end of file
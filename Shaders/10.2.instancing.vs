@@ -1,15 +1,13 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 2) in vec2 aTexCoords;
 
 out vec2 TexCoords;
 
-uniform mat4 projection;
-
-uniform mat4 view;
-
 uniform mat4 model;
 
 void main()
@@ -1,20 +1,22 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+#include "include/frame_uniforms.glsl"
 
-layout (location = 2) in vec2 aTexCoords;
+/* only ever draws Mesh geometry, which is uploaded packed */
+#ifndef PACKED_VERTEX
+#define PACKED_VERTEX 1
+#endif
 
-layout (location = 3) in mat4 aInstanceMatrix;
+#include "include/mesh_vertex.glsl"
 
-out vec2 TexCoords;
-
-uniform mat4 projection;
+/* GeometryArena::INSTANCE_MATRIX_ATTRIBUTE, location 3 is the packed tangent */
+layout (location = 8) in mat4 aInstanceMatrix;
 
-uniform mat4 view;
+out vec2 TexCoords;
 
 void main()
 {
 	TexCoords = aTexCoords;
 
-	gl_Position = projection * view * aInstanceMatrix * vec4(aPos, 1.f);
+	gl_Position = projection * view * aInstanceMatrix * vec4(vertexPosition(), 1.f);
 }
\ No newline at end of file
@@ -1,14 +1,15 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+#include "include/frame_uniforms.glsl"
 
-layout (location = 2) in vec2 aTexCoords;
+/* only ever draws Mesh geometry, which is uploaded packed */
+#ifndef PACKED_VERTEX
+#define PACKED_VERTEX 1
+#endif
 
-out vec2 TexCoords;
-
-uniform mat4 projection;
+#include "include/mesh_vertex.glsl"
 
-uniform mat4 view;
+out vec2 TexCoords;
 
 uniform mat4 model;
 
@@ -16,5 +17,5 @@ void main()
 {
     TexCoords = aTexCoords;
 
-    gl_Position = projection * view * model * vec4(aPos, 1.0f); 
+    gl_Position = projection * view * model * vec4(vertexPosition(), 1.0f); 
 }
\ No newline at end of file
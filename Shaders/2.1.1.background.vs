@@ -1,10 +1,8 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-
-uniform mat4 projection;
+#include "include/frame_uniforms.glsl"
 
-uniform mat4 view;
+layout (location = 0) in vec3 aPos;
 
 out vec3 WorldPos;
 
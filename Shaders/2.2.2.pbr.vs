@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 1) in vec2 aTexCoords;
@@ -12,10 +14,6 @@ out vec3 WorldPos;
 
 out vec3 Normal;
 
-uniform mat4 projection;
-
-uniform mat4 view;
-
 uniform mat4 model;
 
 void main()
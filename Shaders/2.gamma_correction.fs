@@ -1,5 +1,9 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
+#include "include/light_uniforms.glsl"
+
 out vec4 FragColor;
 
 in VS_OUT {
@@ -12,12 +16,6 @@ in VS_OUT {
 
 uniform sampler2D floorTexture;
 
-uniform vec3 lightPositions[4];
-
-uniform vec3 lightColors[4];
-
-uniform vec3 viewPos;
-
 uniform bool gamma;
 
 vec3 BlinnPhong(vec3 normal, vec3 fragPos, vec3 lightPos, vec3 lightColor)
@@ -58,9 +56,9 @@ void main()
 
     vec3 lighting = vec3(0.f);
 
-    for(int i = 0; i < 4 ; ++i)
+    for(int i = 0; i < lightCount; ++i)
     {
-        lighting += BlinnPhong(normalize(fs_in.Normal), fs_in.FragPos, lightPositions[i], lightColors[i]);
+        lighting += BlinnPhong(normalize(fs_in.Normal), fs_in.FragPos, lights[i].Position, lights[i].Color);
     }
 
     color *= lighting;
@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 1) in vec3 aNormal;
@@ -15,10 +17,6 @@ out VS_OUT {
     vec2 TexCoords;
 } vs_out;
 
-uniform mat4 projection;
-
-uniform mat4 view;
-
 void main()
 {
     vs_out.FragPos = aPos;
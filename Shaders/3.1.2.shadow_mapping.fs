@@ -1,5 +1,12 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
+/* PCF_RADIUS: the shadow map is filtered over a (2 * PCF_RADIUS + 1)^2 texel kernel, 0 disables filtering */
+#ifndef PCF_RADIUS
+#define PCF_RADIUS 1
+#endif
+
 out vec4 FragColor;
 
 in VS_OUT {
@@ -18,8 +25,6 @@ uniform sampler2D shadowMap;
 
 uniform vec3 lightPos;
 
-uniform vec3 viewPos;
-
 float ShadowCalculation(vec4 fragPosLightSpace)
 {
 	/* perform perspective divide */
@@ -46,9 +51,9 @@ float ShadowCalculation(vec4 fragPosLightSpace)
 
 	vec2 texelSize = 1.f / textureSize(shadowMap, 0);
 
-	for(int x = -1; x <= 1; ++x)
+	for(int x = -PCF_RADIUS; x <= PCF_RADIUS; ++x)
 	{
-		for(int y = -1; y <= 1; ++y)
+		for(int y = -PCF_RADIUS; y <= PCF_RADIUS; ++y)
 		{
 			float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
 		
@@ -56,7 +61,7 @@ float ShadowCalculation(vec4 fragPosLightSpace)
 		}
 	}
 
-	shadow /= 9.f;
+	shadow /= float((2 * PCF_RADIUS + 1) * (2 * PCF_RADIUS + 1));
 
 	/* Keep the shadow at 0.0 when outside the far_plane region of the light's frustum. */
 	if(projCoords.z > 1.f)
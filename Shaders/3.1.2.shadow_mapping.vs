@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 1) in vec3 aNormal;
@@ -18,10 +20,6 @@ out VS_OUT {
 	vec4 FragPosLightSpace;
 } vs_out;
 
-uniform mat4 projection;
-
-uniform mat4 view;
-
 uniform mat4 model;
 
 uniform mat4 lightSpaceMatrix;
@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 out vec4 FragColor;
 
 in VS_OUT {
@@ -16,8 +18,6 @@ uniform samplerCube depthMap;
 
 uniform vec3 lightPos;
 
-uniform vec3 viewPos;
-
 uniform float far_plane;
 
 float ShadowCalculation(vec3 fragPos)
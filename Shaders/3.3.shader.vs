@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 1) in vec2 aTexCoord;
@@ -8,10 +10,6 @@ out vec2 TexCoord;
 
 uniform mat4 model;
 
-uniform mat4 view;
-
-uniform mat4 projection;
-
 void main()
 {
 	gl_Position = projection * view * model * vec4(aPos, 1.f);
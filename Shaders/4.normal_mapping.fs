@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 out vec4 FragColor;
 
 in VS_OUT {
@@ -20,8 +22,6 @@ uniform sampler2D normalMap;
 
 uniform vec3 lightPos;
 
-uniform vec3 viewPos;
-
 void main()
 {
     /* obtain normal from normal map in range [0,1] */
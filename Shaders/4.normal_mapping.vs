@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 layout (location = 1) in vec3 aNormal;
@@ -22,16 +24,10 @@ out VS_OUT {
     vec3 TangentFragPos;
 } vs_out;
 
-uniform mat4 projection;
-
-uniform mat4 view;
-
 uniform mat4 model;
 
 uniform vec3 lightPos;
 
-uniform vec3 viewPos;
-
 void main()
 {
     vs_out.FragPos = vec3(model * vec4(aPos, 1.f));
@@ -1,18 +1,17 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-
-uniform mat4 view;
-
 void main()
 {
     TexCoords = aPos;
 
-    vec4 pos = projection * view * vec4(aPos, 1.f);
+    /* the skybox follows the camera, only the rotation of the shared view matrix applies */
+    vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.f);
 
     gl_Position = pos.xyww;
 }  
\ No newline at end of file
@@ -1,18 +1,18 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 out vec4 FragColor;
 
 in vec3 Normal;
 
 in vec3 Position;
 
-uniform vec3 cameraPos;
-
 uniform samplerCube skybox;
 
 void main()
 {    
-    vec3 I = normalize(Position - cameraPos);
+    vec3 I = normalize(Position - viewPos);
 
     vec3 R = reflect(I, normalize(Normal));
 
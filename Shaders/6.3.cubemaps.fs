@@ -1,20 +1,20 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 out vec4 FragColor;
 
 in vec3 Normal;
 
 in vec3 Position;
 
-uniform vec3 cameraPos;
-
 uniform samplerCube skybox;
 
 void main()
 {    
     float ratio = 1.f / 1.52f;
 
-    vec3 I = normalize(Position - cameraPos);
+    vec3 I = normalize(Position - viewPos);
 
     vec3 R = refract(I, normalize(Normal), ratio);
 
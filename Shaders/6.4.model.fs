@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
 out vec4 FragColor;
 
 in vec3 Normal;
@@ -8,8 +10,6 @@ in vec3 Position;
 
 in vec2 TexCoords;
 
-uniform vec3 cameraPos;
-
 uniform sampler2D texture_diffuse0;
 
 uniform sampler2D texture_reflection0;
@@ -22,7 +22,7 @@ void main()
     vec3 diffuse = vec3(texture(texture_diffuse0, TexCoords));
 
     /* Reflection */
-    vec3 I = normalize(Position - cameraPos);
+    vec3 I = normalize(Position - viewPos);
 
     vec3 R = reflect(I, normalize(Normal));
 
@@ -1,10 +1,13 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+#include "include/frame_uniforms.glsl"
 
-layout (location = 1) in vec3 aNormal;
+/* only ever draws Mesh geometry, which is uploaded packed */
+#ifndef PACKED_VERTEX
+#define PACKED_VERTEX 1
+#endif
 
-layout (location = 2) in vec2 aTexCoords;
+#include "include/mesh_vertex.glsl"
 
 out vec3 Normal;
 
@@ -14,17 +17,13 @@ out vec2 TexCoords;
 
 uniform mat4 model;
 
-uniform mat4 view;
-
-uniform mat4 projection;
-
 void main()
 {
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = mat3(transpose(inverse(model))) * vertexNormal();
 
-    Position = vec3(model * vec4(aPos, 1.0));
+    Position = vec3(model * vec4(vertexPosition(), 1.0));
 
     TexCoords = aTexCoords;
 
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * model * vec4(vertexPosition(), 1.0);
 }
\ No newline at end of file
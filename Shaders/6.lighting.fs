@@ -1,5 +1,9 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
+#include "include/light_uniforms.glsl"
+
 out vec4 FragColor;
 
 in VS_OUT {
@@ -10,18 +14,8 @@ in VS_OUT {
     vec2 TexCoords;
 } fs_in;
 
-struct Light {
-    vec3 Position;
-
-    vec3 Color;
-};
-
-uniform Light lights[16];
-
 uniform sampler2D diffuseTexture;
 
-uniform vec3 viewPos;
-
 void main()
 {
     vec3 color = texture(diffuseTexture, fs_in.TexCoords).rgb;
@@ -34,7 +28,7 @@ void main()
     /* lighting */
     vec3 lighting = vec3(0.f);
 
-    for(int i = 0; i < 16; ++i)
+    for(int i = 0; i < lightCount; ++i)
     {
         /* diffuse */
         vec3 lightDir = normalize(lights[i].Position - fs_in.FragPos);
@@ -45,7 +39,7 @@ void main()
 
         vec3 result = diffuse;
 
-        /* attenuation (use quadratic as we have gamma correction) */
+        /* attenuation (use quadratic as we have gamma correction), the light list's Linear/Quadratic terms are not used here */
         float distance = length(fs_in.FragPos - lights[i].Position);
 
         result *= 1.f / (distance * distance);
@@ -1,5 +1,9 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
+#include "include/light_uniforms.glsl"
+
 layout (location = 0) out vec4 FragColor;
 
 layout (location = 1) out vec4 BrightColor;
@@ -12,18 +16,8 @@ in VS_OUT {
     vec2 TexCoords;
 } fs_in;
 
-struct Light {
-    vec3 Position;
-
-    vec3 Color;
-};
-
-uniform Light lights[4];
-
 uniform sampler2D diffuseTexture;
 
-uniform vec3 viewPos;
-
 void main()
 {
     vec3 color = texture(diffuseTexture, fs_in.TexCoords).rgb;
@@ -38,7 +32,7 @@ void main()
 
     vec3 viewDir = normalize(viewPos - fs_in.FragPos);
 
-    for(int i = 0; i < 4; ++i)
+    for(int i = 0; i < lightCount; ++i)
     {
         /* diffuse */
         vec3 lightDir = normalize(lights[i].Position - fs_in.FragPos);
@@ -47,7 +41,7 @@ void main()
 
         vec3 result = lights[i].Color * diff * color;
 
-        /* attenuation (use quadratic as we have gamma correction) */
+        /* attenuation (use quadratic as we have gamma correction), the light list's Linear/Quadratic terms are not used here */
         float distance = length(fs_in.FragPos - lights[i].Position);
 
         result *= 1.f / (distance * distance);
@@ -10,21 +10,9 @@ uniform sampler2D gNormal;
 
 uniform sampler2D gAlbedoSpec;
 
-struct Light {
-    vec3 Position;
+#include "include/frame_uniforms.glsl"
 
-    vec3 Color;
-    
-    float Linear;
-
-    float Quadratic;
-};
-
-const int NR_LIGHTS = 32;
-
-uniform Light lights[NR_LIGHTS];
-
-uniform vec3 viewPos;
+#include "include/light_uniforms.glsl"
 
 void main()
 {             
@@ -43,7 +31,7 @@ void main()
 
     vec3 viewDir  = normalize(viewPos - FragPos);
 
-    for(int i = 0; i < NR_LIGHTS; ++i)
+    for(int i = 0; i < lightCount; ++i)
     {
         /* diffuse */
         vec3 lightDir = normalize(lights[i].Position - FragPos);
@@ -1,10 +1,6 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-
-layout (location = 1) in vec3 aNormal;
-
-layout (location = 2) in vec2 aTexCoords;
+#include "include/mesh_vertex.glsl"
 
 out vec3 FragPos;
 
@@ -12,15 +8,13 @@ out vec2 TexCoords;
 
 out vec3 Normal;
 
-uniform mat4 model;
+#include "include/frame_uniforms.glsl"
 
-uniform mat4 view;
-
-uniform mat4 projection;
+uniform mat4 model;
 
 void main()
 {
-    vec4 worldPos = model * vec4(aPos, 1.0);
+    vec4 worldPos = model * vec4(vertexPosition(), 1.0);
 
     FragPos = worldPos.xyz; 
 
@@ -28,7 +22,7 @@ void main()
     
     mat3 normalMatrix = transpose(inverse(mat3(model)));
 
-    Normal = normalMatrix * aNormal;
+    Normal = normalMatrix * vertexNormal();
 
     gl_Position = projection * view * worldPos;
 }
\ No newline at end of file
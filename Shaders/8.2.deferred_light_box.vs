@@ -6,9 +6,7 @@ layout (location = 1) in vec3 aNormal;
 
 layout (location = 2) in vec2 aTexCoords;
 
-uniform mat4 projection;
-
-uniform mat4 view;
+#include "include/frame_uniforms.glsl"
 
 uniform mat4 model;
 
@@ -10,23 +10,9 @@ uniform sampler2D gNormal;
 
 uniform sampler2D gAlbedoSpec;
 
-struct Light {
-    vec3 Position;
+#include "include/frame_uniforms.glsl"
 
-    vec3 Color;
-    
-    float Linear;
-
-    float Quadratic;
-
-    float Radius;
-};
-
-const int NR_LIGHTS = 32;
-
-uniform Light lights[NR_LIGHTS];
-
-uniform vec3 viewPos;
+#include "include/light_uniforms.glsl"
 
 void main()
 {             
@@ -45,7 +31,7 @@ void main()
 
     vec3 viewDir  = normalize(viewPos - FragPos);
 
-    for(int i = 0; i < NR_LIGHTS; ++i)
+    for(int i = 0; i < lightCount; ++i)
     {
         /* calculate distance between light source and current fragment */
         float distance = length(lights[i].Position - FragPos);
@@ -1,5 +1,8 @@
 #version 330 core
 
+/* time comes from the shared frame block */
+#include "include/frame_uniforms.glsl"
+
 layout (triangles) in;
 
 layout (triangle_strip, max_vertices = 3) out;
@@ -10,8 +13,6 @@ in VS_OUT {
 
 out vec2 TexCoords;
 
-uniform float time;
-
 vec4 explode(vec4 position, vec3 normal)
 {
 	float magnitude = 2.f;
@@ -1,24 +1,25 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+#include "include/frame_uniforms.glsl"
 
-layout (location = 1) in vec3 aNormal;
+/* only ever draws Mesh geometry, which is uploaded packed */
+#ifndef PACKED_VERTEX
+#define PACKED_VERTEX 1
+#endif
+
+#include "include/mesh_vertex.glsl"
 
 out VS_OUT {
 	vec3 normal;
 } vs_out;
 
-uniform mat4 projection;
-
-uniform mat4 view;
-
 uniform mat4 model;
 
 void main()
 {
 	mat3 normalMatrix = mat3(transpose(inverse(view * model)));
 
-	vs_out.normal = vec3(projection * vec4(normalMatrix * aNormal, 0.f));
+	vs_out.normal = vec3(projection * vec4(normalMatrix * vertexNormal(), 0.f));
 
-	gl_Position = projection * view * model * vec4(aPos, 1.f);
+	gl_Position = projection * view * model * vec4(vertexPosition(), 1.f);
 }
\ No newline at end of file
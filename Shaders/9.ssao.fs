@@ -1,5 +1,12 @@
 #version 330 core
 
+#include "include/frame_uniforms.glsl"
+
+/* KERNEL_SIZE: number of samples taken per fragment, the application uploads at least this many samples */
+#ifndef KERNEL_SIZE
+#define KERNEL_SIZE 64
+#endif
+
 out float FragColor;
 
 in vec2 TexCoords;
@@ -10,20 +17,18 @@ uniform sampler2D gNormal;
 
 uniform sampler2D texNoise;
 
-uniform vec3 samples[64];
+uniform vec3 samples[KERNEL_SIZE];
 
 /* parameters (you'd probably want to use them as uniforms to more easily tweak the effect) */
-int kernelSize = 64;
+const int kernelSize = KERNEL_SIZE;
 
-float radius = 0.5f;
+const float radius = 0.5f;
 
-float bias = 0.025f;
+const float bias = 0.025f;
 
 /* tile noise texture over screen based on screen dimensions divided by noise size */
 const vec2 noiseScale = vec2(1280.0/4.0, 720.0/4.0);
 
-uniform mat4 projection;
-
 void main()
 {
 	/* get input for SSAO algorithm */
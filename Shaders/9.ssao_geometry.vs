@@ -1,10 +1,8 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+#include "include/frame_uniforms.glsl"
 
-layout (location = 1) in vec3 aNormal;
-
-layout (location = 2) in vec2 aTexCoords;
+#include "include/mesh_vertex.glsl"
 
 out vec3 FragPos;
 
@@ -16,21 +14,17 @@ uniform bool invertedNormals;
 
 uniform mat4 model;
 
-uniform mat4 view;
-
-uniform mat4 projection;
-
 void main()
 {
-	vec4 viewPos = view * model * vec4(aPos, 1.f);
+	vec4 viewSpacePos = view * model * vec4(vertexPosition(), 1.f);
 
-	FragPos = viewPos.xyz;
+	FragPos = viewSpacePos.xyz;
 
 	TexCoords = aTexCoords;
 
 	mat3 normalMatrix = transpose(inverse(mat3(view * model)));
 
-	Normal = normalMatrix * (invertedNormals ? -aNormal : aNormal);
+	Normal = normalMatrix * (invertedNormals ? -vertexNormal() : vertexNormal());
 
-	gl_Position = projection * viewPos;
+	gl_Position = projection * viewSpacePos;
 }
\ No newline at end of file
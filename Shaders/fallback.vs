@@ -0,0 +1,17 @@
+#version 330 core
+
+/* stand-in of ShaderLibrary while a program is pending or after it failed, draws Mesh geometry in flat magenta */
+#include "include/frame_uniforms.glsl"
+
+#ifndef PACKED_VERTEX
+#define PACKED_VERTEX 1
+#endif
+
+#include "include/mesh_vertex.glsl"
+
+uniform mat4 model;
+
+void main()
+{
+	gl_Position = projection * view * model * vec4(vertexPosition(), 1.f);
+}
@@ -0,0 +1,11 @@
+/* per-frame camera data, mirrored by FrameBlock in FrameUniforms.h and uploaded once per frame */
+layout (std140) uniform FrameData
+{
+	mat4 projection;
+
+	mat4 view;
+
+	vec3 viewPos;
+
+	float time;
+};
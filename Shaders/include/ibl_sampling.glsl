@@ -0,0 +1,56 @@
+/* low-discrepancy importance sampling used by the IBL precomputation shaders */
+#include "pbr_common.glsl"
+
+/* http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html */
+/* efficient VanDerCorpus calculation. */
+float RadicalInverse_VdC(uint bits)
+{
+	bits = (bits << 16u) | (bits >> 16u);
+	
+	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+	
+	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+	
+	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+	
+	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+	
+	/* / 0x100000000 */
+	return float(bits) * 2.3283064365386963e-10;
+}
+
+vec2 Hammersley(uint i, uint N)
+{
+	return vec2(float(i)/float(N), RadicalInverse_VdC(i));
+}
+
+vec3 ImportanceSampleGGX(vec2 Xi, vec3 N, float roughness)
+{
+	float a = roughness*roughness;
+	
+	float phi = 2.f * PI * Xi.x;
+	
+	float cosTheta = sqrt((1.f - Xi.y) / (1.f + (a*a - 1.f) * Xi.y));
+	
+	float sinTheta = sqrt(1.f - cosTheta*cosTheta);
+	
+	/* from spherical coordinates to cartesian coordinates - halfway vector */
+	vec3 H;
+	
+	H.x = cos(phi) * sinTheta;
+	
+	H.y = sin(phi) * sinTheta;
+	
+	H.z = cosTheta;
+	
+	/* from tangent-space H vector to world-space sample vector */
+	vec3 up = abs(N.z) < 0.999f ? vec3(0.f, 0.f, 1.f) : vec3(1.f, 0.f, 0.f);
+	
+	vec3 tangent = normalize(cross(up, N));
+	
+	vec3 bitangent = cross(N, tangent);
+	
+	vec3 sampleVec = tangent * H.x + bitangent * H.y + N * H.z;
+	
+	return normalize(sampleVec);
+}
@@ -0,0 +1,22 @@
+/* per-frame light list, mirrored by LightBlock in FrameUniforms.h and uploaded once per frame */
+#define MAX_LIGHTS 256
+
+/* members are ordered so that every vec3 shares its 16 bytes with a float (std140) */
+struct Light {
+	vec3 Position;
+
+	float Linear;
+
+	vec3 Color;
+
+	float Quadratic;
+
+	float Radius;
+};
+
+layout (std140) uniform LightData
+{
+	int lightCount;
+
+	Light lights[MAX_LIGHTS];
+};
@@ -0,0 +1,127 @@
+/*
+ * vertex inputs of Mesh geometry: the packed layout Mesh uploads (PACKED_VERTEX=1, PackedVertex in Mesh.h)
+ * or plain floats for hand built buffers. define MESH_VERTEX_TANGENT before including to get the tangent frame,
+ * and MESH_DRAW_BATCHED (packed only) for shaders used with the batched path of Model::Draw.
+ * shaders that only draw Mesh default PACKED_VERTEX to 1 before including, the float default is kept for the
+ * ones that also draw hand built buffers (8.x g_buffer, 9.ssao_geometry).
+ */
+#ifndef PACKED_VERTEX
+#define PACKED_VERTEX 0
+#endif
+
+#if PACKED_VERTEX
+/* xyz normalised to the mesh bounds, w is the tangent frame handedness (0 or 1) */
+layout (location = 0) in vec4 aPackedPosition;
+
+/* octahedral encoded unit vectors */
+layout (location = 1) in vec2 aPackedNormal;
+
+/* half floats, no decode needed */
+layout (location = 2) in vec2 aTexCoords;
+
+#ifdef MESH_VERTEX_TANGENT
+layout (location = 3) in vec2 aPackedTangent;
+#endif
+
+#ifdef MESH_DRAW_BATCHED
+/*
+ * batched draws of Model::Draw: the draw index (GeometryArena::DRAW_INDEX_ATTRIBUTE) selects two texels of
+ * per draw data, the mesh bounds scale (w is the material bucket) and offset
+ */
+layout (location = 7) in uint aDrawIndex;
+
+uniform samplerBuffer meshDrawData;
+
+vec3 meshPositionScale()
+{
+	return texelFetch(meshDrawData, int(aDrawIndex) * 2).xyz;
+}
+
+vec3 meshPositionOffset()
+{
+	return texelFetch(meshDrawData, int(aDrawIndex) * 2 + 1).xyz;
+}
+#else
+/* mesh bounds, set by Mesh::Draw */
+uniform vec3 positionScale;
+
+uniform vec3 positionOffset;
+
+vec3 meshPositionScale()
+{
+	return positionScale;
+}
+
+vec3 meshPositionOffset()
+{
+	return positionOffset;
+}
+#endif
+
+vec3 octahedralDecode(vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+
+	float t = max(-v.z, 0.0);
+
+	v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);
+
+	return normalize(v);
+}
+
+vec3 vertexPosition()
+{
+	return meshPositionOffset() + aPackedPosition.xyz * meshPositionScale();
+}
+
+vec3 vertexNormal()
+{
+	return octahedralDecode(aPackedNormal);
+}
+
+#ifdef MESH_VERTEX_TANGENT
+vec3 vertexTangent()
+{
+	return octahedralDecode(aPackedTangent);
+}
+
+vec3 vertexBitangent()
+{
+	return cross(vertexNormal(), vertexTangent()) * (aPackedPosition.w * 2.0 - 1.0);
+}
+#endif
+#else
+layout (location = 0) in vec3 aPos;
+
+layout (location = 1) in vec3 aNormal;
+
+layout (location = 2) in vec2 aTexCoords;
+
+#ifdef MESH_VERTEX_TANGENT
+layout (location = 3) in vec3 aTangent;
+
+layout (location = 4) in vec3 aBitangent;
+#endif
+
+vec3 vertexPosition()
+{
+	return aPos;
+}
+
+vec3 vertexNormal()
+{
+	return aNormal;
+}
+
+#ifdef MESH_VERTEX_TANGENT
+vec3 vertexTangent()
+{
+	return aTangent;
+}
+
+vec3 vertexBitangent()
+{
+	return aBitangent;
+}
+#endif
+#endif
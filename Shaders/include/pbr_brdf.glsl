@@ -0,0 +1,57 @@
+/* Cook-Torrance BRDF terms shared by the PBR and IBL shaders */
+#include "pbr_common.glsl"
+
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+	float a = roughness*roughness;
+	
+	float a2 = a * a;
+	
+	float NdotH = max(dot(N, H), 0.f);
+	
+	float NdotH2 = NdotH * NdotH;
+	
+	float nom   = a2;
+	
+	float denom = (NdotH2 * (a2 - 1.f) + 1.f);
+	
+	denom = PI * denom * denom;
+	
+	return nom / denom;
+}
+
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+	float r = (roughness + 1.f);
+	
+	float k = (r * r) / 8.f;
+	
+	float nom   = NdotV;
+	
+	float denom = NdotV * (1.f - k) + k;
+	
+	return nom / denom;
+}
+
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+	float NdotV = max(dot(N, V), 0.f);
+	
+	float NdotL = max(dot(N, L), 0.f);
+	
+	float ggx2 = GeometrySchlickGGX(NdotV, roughness);
+	
+	float ggx1 = GeometrySchlickGGX(NdotL, roughness);
+	
+	return ggx1 * ggx2;
+}
+
+vec3 fresnelSchlick(float cosTheta, vec3 F0)
+{
+	return F0 + (1.f - F0) * pow(1.f - cosTheta, 5.f);
+}
+
+vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness)
+{
+	return F0 + (max(vec3(1.f - roughness), F0) - F0) * pow(1.f - cosTheta, 5.f);
+}
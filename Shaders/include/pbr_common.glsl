@@ -0,0 +1,2 @@
+/* constants shared by the PBR and IBL shaders */
+const float PI = 3.14159265359f;
@@ -0,0 +1,182 @@
+#include "TextureCache.h"
+#include "GLStateCache.h"
+#include "TextureLoader.h"
+#include "glad/glad.h"
+#include <cctype>
+#include <functional>
+#include <vector>
+
+std::unordered_map<TextureCache::Key, TextureCache::Entry, TextureCache::KeyHash> TextureCache::entries;
+
+std::unordered_map<unsigned int, TextureCache::Key> TextureCache::keys;
+
+bool TextureCache::Key::operator==(const Key& other) const
+{
+	return gamma == other.gamma && path == other.path;
+}
+
+size_t TextureCache::KeyHash::operator()(const Key& key) const
+{
+	return std::hash<std::string>()(key.path) ^ static_cast<size_t>(key.gamma);
+}
+
+std::string TextureCache::canonicalPath(const std::string& path)
+{
+	const auto absolute = !path.empty() && (path[0] == '/' || path[0] == '\\');
+
+	std::vector<std::string> parts;
+
+	std::string part;
+
+	for (auto i = 0u; i <= path.size(); ++i)
+	{
+		const auto c = i < path.size() ? path[i] : '/';
+
+		if (c != '/' && c != '\\')
+		{
+#ifdef _WIN32
+			part += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+#else
+			part += c;
+#endif
+
+			continue;
+		}
+
+		/* a leading ".." of a relative path can't be resolved without the file system, it is kept */
+		if (part == ".." && !parts.empty() && parts.back() != "..")
+		{
+			parts.pop_back();
+		}
+		else if (!part.empty() && part != "." && !(part == ".." && absolute))
+		{
+			parts.push_back(part);
+		}
+
+		part.clear();
+	}
+
+	std::string result = absolute ? "/" : "";
+
+	for (auto i = 0u; i < parts.size(); ++i)
+	{
+		if (i > 0)
+		{
+			result += '/';
+		}
+
+		result += parts[i];
+	}
+
+	return result;
+}
+
+unsigned int TextureCache::acquire(const std::string& path, const bool gamma)
+{
+	Key key{canonicalPath(path), gamma};
+
+	const auto found = entries.find(key);
+
+	if (found != entries.end())
+	{
+		++found->second.references;
+
+		return found->second.texture;
+	}
+
+	const auto texture = TextureLoader::load(key.path, gamma);
+
+	keys.emplace(texture, key);
+
+	entries.emplace(std::move(key), Entry{texture, 1});
+
+	return texture;
+}
+
+void TextureCache::release(const unsigned int texture)
+{
+	const auto key = keys.find(texture);
+
+	if (key == keys.end())
+	{
+		return;
+	}
+
+	const auto entry = entries.find(key->second);
+
+	if (--entry->second.references > 0)
+	{
+		return;
+	}
+
+	entries.erase(entry);
+
+	keys.erase(key);
+
+	/* the name can be handed out again, nothing may upload into it later */
+	TextureLoader::cancel(texture);
+
+	GLStateCache::forgetTexture(texture);
+
+	glDeleteTextures(1, &texture);
+}
+
+unsigned int TextureCache::getReferenceCount(const unsigned int texture)
+{
+	const auto key = keys.find(texture);
+
+	return key != keys.end() ? entries.at(key->second).references : 0;
+}
+
+size_t TextureCache::size()
+{
+	return entries.size();
+}
+
+TextureHandle::TextureHandle(const unsigned int texture) : texture(texture)
+{
+}
+
+TextureHandle::~TextureHandle()
+{
+	reset();
+}
+
+TextureHandle::TextureHandle(TextureHandle&& other) noexcept : texture(other.texture)
+{
+	other.texture = 0;
+}
+
+TextureHandle& TextureHandle::operator=(TextureHandle&& other) noexcept
+{
+	if (this != &other)
+	{
+		reset();
+
+		texture = other.texture;
+
+		other.texture = 0;
+	}
+
+	return *this;
+}
+
+unsigned int TextureHandle::get() const
+{
+	return texture;
+}
+
+bool TextureHandle::isValid() const
+{
+	return texture != 0;
+}
+
+void TextureHandle::reset()
+{
+	if (texture != 0)
+	{
+		TextureCache::release(texture);
+
+		texture = 0;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+/*
+ * Textures shared by every model in the process, keyed by the canonical path of the file and the load parameters.
+ * The first acquire loads the file through TextureLoader, later ones return the same texture and add a reference.
+ * The texture is deleted when its last reference is released (TextureHandle does that when it goes away).
+ */
+class TextureCache
+{
+public:
+	/*
+	 * lexically normalized path used as the key: separators become '/', "." and empty parts are dropped and
+	 * ".." removes the part before it, so "Objects/nanosuit/../rock/rock.png" and "Objects/rock/rock.png" match.
+	 * case is folded on Windows
+	 */
+	static std::string canonicalPath(const std::string& path);
+
+	/* the texture of a file, loaded on the first request. every acquire has to be paired with a release */
+	static unsigned int acquire(const std::string& path, bool gamma = false);
+
+	/* drops one reference, the last one deletes the texture (and cancels its upload if it is still pending) */
+	static void release(unsigned int texture);
+
+	/* references held on a texture, 0 if the cache doesn't know it */
+	static unsigned int getReferenceCount(unsigned int texture);
+
+	/* textures currently alive */
+	static size_t size();
+
+private:
+	struct Key
+	{
+		std::string path;
+
+		bool gamma;
+
+		bool operator==(const Key& other) const;
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const;
+	};
+
+	struct Entry
+	{
+		unsigned int texture;
+
+		unsigned int references;
+	};
+
+	static std::unordered_map<Key, Entry, KeyHash> entries;
+
+	/* texture name back to its entry, for release */
+	static std::unordered_map<unsigned int, Key> keys;
+};
+
+/* holds one reference of a cached texture and releases it when it goes away, so it can be moved but not copied */
+class TextureHandle
+{
+public:
+	TextureHandle() = default;
+
+	/* adopts a reference returned by TextureCache::acquire */
+	explicit TextureHandle(unsigned int texture);
+
+	~TextureHandle();
+
+	TextureHandle(const TextureHandle&) = delete;
+
+	TextureHandle& operator=(const TextureHandle&) = delete;
+
+	/* the source is left empty */
+	TextureHandle(TextureHandle&& other) noexcept;
+
+	TextureHandle& operator=(TextureHandle&& other) noexcept;
+
+	/* the texture name, 0 if empty */
+	unsigned int get() const;
+
+	bool isValid() const;
+
+	/* releases the reference now */
+	void reset();
+
+private:
+	unsigned int texture = 0;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "TextureLoader.h"
+#include "GLStateCache.h"
+#include "TextureUploader.h"
+#include "ThreadPool.h"
+#include "glad/glad.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stb_image.h>
+
+std::deque<TextureLoader::Request> TextureLoader::requests;
+
+void TextureLoader::PixelDeleter::operator()(unsigned char* pixels) const
+{
+	stbi_image_free(pixels);
+}
+
+unsigned int TextureLoader::load(const std::string& path, const bool gamma)
+{
+	unsigned int textureID;
+
+	glGenTextures(1, &textureID);
+
+	/* grey until the file is decoded, a texture without storage would sample as black */
+	const unsigned char placeholder[4] = {128, 128, 128, 255};
+
+	GLStateCache::bindTexture(0, GL_TEXTURE_2D, textureID);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	/* stb_image keeps its settings and failure reason per thread, decoding is safe on any worker */
+	auto image = ThreadPool::shared().submit([path]()
+	{
+		Image result;
+
+		result.pixels.reset(stbi_load(path.c_str(), &result.width, &result.height, &result.components, 0));
+
+		return result;
+	});
+
+	requests.push_back(Request{textureID, path, gamma, std::move(image)});
+
+	return textureID;
+}
+
+unsigned int TextureLoader::update()
+{
+	while (!requests.empty() &&
+		requests.front().image.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		upload(requests.front());
+
+		requests.pop_front();
+	}
+
+	return TextureUploader::update();
+}
+
+void TextureLoader::finish()
+{
+	while (!requests.empty())
+	{
+		upload(requests.front());
+
+		requests.pop_front();
+	}
+
+	TextureUploader::finish();
+}
+
+void TextureLoader::cancel(const unsigned int texture)
+{
+	/* the decode still runs, its result is dropped with the future */
+	requests.erase(std::remove_if(requests.begin(), requests.end(), [texture](const Request& request)
+	{
+		return request.texture == texture;
+	}), requests.end());
+
+	TextureUploader::cancel(texture);
+}
+
+size_t TextureLoader::getPendingCount()
+{
+	return requests.size() + TextureUploader::getPendingCount();
+}
+
+void TextureLoader::upload(Request& request)
+{
+	auto image = request.image.get();
+
+	if (image.pixels == nullptr)
+	{
+		std::cout << "Texture failed to load at path: " << request.path << std::endl;
+
+		return;
+	}
+
+	GLenum format = GL_RGBA;
+
+	if (image.components == 1)
+	{
+		format = GL_RED;
+	}
+	else if (image.components == 2)
+	{
+		format = GL_RG;
+	}
+	else if (image.components == 3)
+	{
+		format = GL_RGB;
+	}
+
+	/* gamma only applies to colour, single and two channel images are data */
+	auto internalFormat = static_cast<GLint>(format);
+
+	if (request.gamma && format == GL_RGB)
+	{
+		internalFormat = GL_SRGB;
+	}
+	else if (request.gamma && format == GL_RGBA)
+	{
+		internalFormat = GL_SRGB_ALPHA;
+	}
+
+	TextureUploader::upload(request.texture, internalFormat, format, image.width, image.height, image.components,
+	                        std::shared_ptr<const unsigned char>(std::move(image.pixels)));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+
+/*
+ * Texture files decoded on the shared thread pool and uploaded on the GL thread.
+ * load() hands out the texture name right away, so meshes can be registered before any pixels exist;
+ * the texture shows a 1x1 grey placeholder until its pixels reach the GPU. Decoded images are handed to the
+ * TextureUploader in request order, which streams them within its per-frame budget.
+ */
+class TextureLoader
+{
+public:
+	/* creates the texture and queues the file for decoding, gamma stores it as sRGB */
+	static unsigned int load(const std::string& path, bool gamma = false);
+
+	/*
+	 * queues the decoded textures for upload in the order they were requested, up to the first one that is still
+	 * decoding, and runs the uploader's frame. call once per frame on the GL thread. returns the textures completed
+	 */
+	static unsigned int update();
+
+	/* waits for every queued texture and uploads it, for loaders that need the pixels before the first frame */
+	static void finish();
+
+	/* forgets a texture that is about to be deleted, its pixels are never uploaded */
+	static void cancel(unsigned int texture);
+
+	/* textures requested but not completely uploaded yet */
+	static size_t getPendingCount();
+
+private:
+	struct PixelDeleter
+	{
+		void operator()(unsigned char* pixels) const;
+	};
+
+	/* pixels as decoded by stb_image, null if the file couldn't be read */
+	struct Image
+	{
+		std::unique_ptr<unsigned char, PixelDeleter> pixels;
+
+		int width = 0;
+
+		int height = 0;
+
+		int components = 0;
+	};
+
+	struct Request
+	{
+		unsigned int texture;
+
+		std::string path;
+
+		bool gamma;
+
+		std::future<Image> image;
+	};
+
+	static std::deque<Request> requests;
+
+	/* hands the decoded image to the uploader, which replaces the placeholder */
+	static void upload(Request& request);
+};
+
+#endif
@@ -0,0 +1,390 @@
+#include "TextureUploader.h"
+#include "GLExtensions.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	/* staged bands start on this alignment, the copies and the driver's reads stay on whole cache lines */
+	const size_t BAND_ALIGNMENT = 64;
+
+	const GLuint64 WAIT_TIMEOUT = 1000000000;
+
+	/* storage for the whole image at level 0, sampling is limited to it until the mipmaps exist */
+	void allocateStorage(const GLuint texture, const GLint internalFormat, const GLenum format, const int width,
+	                     const int height)
+	{
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+	}
+
+	void completeTexture(const GLuint texture)
+	{
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, texture);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+}
+
+std::deque<TextureUploader::Job> TextureUploader::jobs;
+
+GLuint TextureUploader::buffer = 0;
+
+size_t TextureUploader::frameBudget = DEFAULT_FRAME_BUDGET;
+
+bool TextureUploader::persistent = false;
+
+unsigned char* TextureUploader::mapping = nullptr;
+
+TextureUploader::Segment TextureUploader::segments[SEGMENT_COUNT];
+
+unsigned int TextureUploader::segment = 0;
+
+TextureUploadStats TextureUploader::stats = {};
+
+void TextureUploader::upload(const GLuint texture, const GLint internalFormat, const GLenum format, const int width,
+                             const int height, const int components, std::shared_ptr<const unsigned char> pixels)
+{
+	Job job;
+
+	job.texture = texture;
+
+	job.internalFormat = internalFormat;
+
+	job.format = format;
+
+	job.width = width;
+
+	job.height = height;
+
+	job.rowBytes = static_cast<size_t>(width) * components;
+
+	job.pixels = std::move(pixels);
+
+	job.row = 0;
+
+	jobs.push_back(std::move(job));
+}
+
+unsigned int TextureUploader::update()
+{
+	return uploadSegment(false);
+}
+
+void TextureUploader::finish()
+{
+	while (!jobs.empty())
+	{
+		uploadSegment(true);
+	}
+}
+
+void TextureUploader::cancel(const GLuint texture)
+{
+	/* bands already issued were read from the ring by the time the texture is deleted, GL orders the two */
+	jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [texture](const Job& job)
+	{
+		return job.texture == texture;
+	}), jobs.end());
+}
+
+size_t TextureUploader::getPendingCount()
+{
+	return jobs.size();
+}
+
+void TextureUploader::setFrameBudget(const size_t bytes)
+{
+	if (bytes == frameBudget || bytes == 0)
+	{
+		return;
+	}
+
+	release();
+
+	frameBudget = bytes;
+}
+
+const TextureUploadStats& TextureUploader::getStats()
+{
+	return stats;
+}
+
+void TextureUploader::resetStats()
+{
+	stats = {};
+}
+
+void TextureUploader::shutdown()
+{
+	release();
+
+	jobs.clear();
+}
+
+void TextureUploader::initialize()
+{
+	glGenBuffers(1, &buffer);
+
+	GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+	const auto size = static_cast<GLsizeiptr>(frameBudget * SEGMENT_COUNT);
+
+	persistent = GLEXT_ARB_buffer_storage != 0;
+
+	if (persistent)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+
+		mapping = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+
+		if (mapping == nullptr)
+		{
+			std::cout << "ERROR::TEXTURE_UPLOADER::PERSISTENT_MAPPING_FAILED" << std::endl;
+
+			persistent = false;
+
+			/* immutable storage can't be respecified, start over with a mutable buffer */
+			GLStateCache::forgetBuffer(buffer);
+
+			glDeleteBuffers(1, &buffer);
+
+			glGenBuffers(1, &buffer);
+
+			GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+		}
+	}
+
+	if (!persistent)
+	{
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	}
+
+	GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	segment = 0;
+}
+
+void TextureUploader::release()
+{
+	for (auto& ringSegment : segments)
+	{
+		if (ringSegment.fence != nullptr)
+		{
+			glDeleteSync(ringSegment.fence);
+
+			ringSegment.fence = nullptr;
+		}
+	}
+
+	if (buffer == 0)
+	{
+		return;
+	}
+
+	if (mapping != nullptr)
+	{
+		GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+		GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		mapping = nullptr;
+	}
+
+	GLStateCache::forgetBuffer(buffer);
+
+	glDeleteBuffers(1, &buffer);
+
+	buffer = 0;
+}
+
+unsigned int TextureUploader::uploadSegment(const bool wait)
+{
+	if (jobs.empty())
+	{
+		return 0;
+	}
+
+	if (buffer == 0)
+	{
+		initialize();
+	}
+
+	auto& current = segments[segment];
+
+	if (current.fence != nullptr)
+	{
+		auto status = glClientWaitSync(current.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? WAIT_TIMEOUT : 0);
+
+		while (wait && status == GL_TIMEOUT_EXPIRED)
+		{
+			status = glClientWaitSync(current.fence, 0, WAIT_TIMEOUT);
+		}
+
+		if (status == GL_TIMEOUT_EXPIRED)
+		{
+			++stats.stalls;
+
+			return 0;
+		}
+
+		glDeleteSync(current.fence);
+
+		current.fence = nullptr;
+	}
+
+	if (jobs.front().rowBytes > frameBudget)
+	{
+		const auto completed = uploadDirect(jobs.front());
+
+		jobs.pop_front();
+
+		return completed;
+	}
+
+	/* plan the bands first, storage has to be allocated while no unpack buffer is bound */
+	std::vector<Band> bands;
+
+	size_t used = 0;
+
+	for (auto& job : jobs)
+	{
+		const auto offset = (used + BAND_ALIGNMENT - 1) / BAND_ALIGNMENT * BAND_ALIGNMENT;
+
+		const auto rows = offset < frameBudget
+			                  ? std::min(static_cast<size_t>(job.height - job.row), (frameBudget - offset) / job.rowBytes)
+			                  : 0;
+
+		if (rows == 0)
+		{
+			break;
+		}
+
+		if (job.row == 0)
+		{
+			allocateStorage(job.texture, job.internalFormat, job.format, job.width, job.height);
+		}
+
+		bands.push_back(Band{&job, job.row, static_cast<int>(rows), offset});
+
+		used = offset + rows * job.rowBytes;
+
+		/* a later image never starts before the one in front of it is complete */
+		if (job.row + static_cast<int>(rows) < job.height)
+		{
+			break;
+		}
+	}
+
+	const auto base = static_cast<size_t>(segment) * frameBudget;
+
+	GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+	auto target = mapping + base;
+
+	if (!persistent)
+	{
+		/* the segment's fence has signaled, nothing reads it any more */
+		target = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, base, used,
+		                                                      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+		                                                      GL_MAP_UNSYNCHRONIZED_BIT));
+
+		if (target == nullptr)
+		{
+			std::cout << "ERROR::TEXTURE_UPLOADER::MAPPING_FAILED" << std::endl;
+
+			GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			return 0;
+		}
+	}
+
+	for (const auto& band : bands)
+	{
+		std::memcpy(target + band.offset, band.job->pixels.get() + band.row * band.job->rowBytes,
+		            band.rows * band.job->rowBytes);
+	}
+
+	if (!persistent)
+	{
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+
+	/* stb_image rows are tightly packed */
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	for (const auto& band : bands)
+	{
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, band.job->texture);
+
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, band.row, band.job->width, band.rows, band.job->format, GL_UNSIGNED_BYTE,
+		                reinterpret_cast<const void*>(base + band.offset));
+	}
+
+	/* nothing else may read pixels from the ring by accident */
+	GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	current.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	segment = (segment + 1) % SEGMENT_COUNT;
+
+	stats.bytes += used;
+
+	for (const auto& band : bands)
+	{
+		band.job->row += band.rows;
+	}
+
+	/* bands are in queue order, only the last one can leave its image unfinished */
+	auto completed = 0u;
+
+	while (!jobs.empty() && jobs.front().row == jobs.front().height)
+	{
+		completeTexture(jobs.front().texture);
+
+		jobs.pop_front();
+
+		++completed;
+	}
+
+	stats.textures += completed;
+
+	return completed;
+}
+
+unsigned int TextureUploader::uploadDirect(Job& job)
+{
+	if (job.row == 0)
+	{
+		allocateStorage(job.texture, job.internalFormat, job.format, job.width, job.height);
+	}
+
+	GLStateCache::bindTexture(0, GL_TEXTURE_2D, job.texture);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, job.row, job.width, job.height - job.row, job.format, GL_UNSIGNED_BYTE,
+	                job.pixels.get() + job.row * job.rowBytes);
+
+	stats.bytes += (job.height - job.row) * job.rowBytes;
+
+	job.row = job.height;
+
+	completeTexture(job.texture);
+
+	++stats.textures;
+
+	return 1;
+}
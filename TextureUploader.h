@@ -0,0 +1,135 @@
+#pragma once
+
+#ifndef TEXTURE_UPLOADER_H
+#define TEXTURE_UPLOADER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+/* work done by the uploader since the last resetStats */
+struct TextureUploadStats
+{
+	/* textures whose last row was uploaded */
+	unsigned int textures;
+
+	size_t bytes;
+
+	/* updates that uploaded nothing because the GPU still read the staging segment */
+	unsigned int stalls;
+};
+
+/*
+ * Streams texture pixels to the GPU through a pixel unpack buffer ring. The ring is split into SEGMENT_COUNT
+ * segments of one frame budget each, update() copies rows into the next segment, issues glTexSubImage2D from
+ * its offsets and fences it. A segment is only written again once its fence has signaled, if it hasn't the
+ * frame skips its uploads instead of waiting. Images larger than the budget are uploaded a band of rows per frame.
+ * With GL_ARB_buffer_storage the ring stays mapped (persistent, coherent), on plain 3.3 each segment is mapped
+ * unsynchronized for the copy, the fences already guarantee the GPU is done with it.
+ */
+class TextureUploader
+{
+public:
+	static const unsigned int SEGMENT_COUNT = 3;
+
+	static const size_t DEFAULT_FRAME_BUDGET = 4 * 1024 * 1024;
+
+	/*
+	 * queues an image for the texture, uploads happen in the order they were queued.
+	 * the texture keeps its current contents until update() starts on it, then shows the rows uploaded so far
+	 * (mipmaps are generated after the last row)
+	 */
+	static void upload(GLuint texture, GLint internalFormat, GLenum format, int width, int height, int components,
+	                   std::shared_ptr<const unsigned char> pixels);
+
+	/* uploads up to one frame budget of queued rows, call once per frame on the GL thread. returns the textures completed */
+	static unsigned int update();
+
+	/* uploads everything queued, waiting for the GPU where the ring is still in use */
+	static void finish();
+
+	/* drops the queued image of a texture that is about to be deleted */
+	static void cancel(GLuint texture);
+
+	/* textures queued and not completed yet */
+	static size_t getPendingCount();
+
+	/* bytes uploaded per update and the size of a ring segment, the ring is recreated when it changes */
+	static void setFrameBudget(size_t bytes);
+
+	static const TextureUploadStats& getStats();
+
+	static void resetStats();
+
+	/* deletes the ring, queued images are dropped */
+	static void shutdown();
+
+private:
+	struct Job
+	{
+		GLuint texture;
+
+		GLint internalFormat;
+
+		GLenum format;
+
+		int width;
+
+		int height;
+
+		size_t rowBytes;
+
+		std::shared_ptr<const unsigned char> pixels;
+
+		/* rows uploaded so far */
+		int row;
+	};
+
+	/* one glTexSubImage2D of a band of rows staged at an offset of the ring */
+	struct Band
+	{
+		Job* job;
+
+		int row;
+
+		int rows;
+
+		size_t offset;
+	};
+
+	struct Segment
+	{
+		GLsync fence = nullptr;
+	};
+
+	static std::deque<Job> jobs;
+
+	static GLuint buffer;
+
+	static size_t frameBudget;
+
+	static bool persistent;
+
+	/* base of the ring while it is persistently mapped */
+	static unsigned char* mapping;
+
+	static Segment segments[SEGMENT_COUNT];
+
+	static unsigned int segment;
+
+	static TextureUploadStats stats;
+
+	static void initialize();
+
+	/* deletes the fences and the ring, GL keeps the buffer alive until pending uploads have read it */
+	static void release();
+
+	/* uploads a frame budget into the current segment, wait blocks on its fence instead of skipping the frame */
+	static unsigned int uploadSegment(bool wait);
+
+	/* a row longer than a whole segment is uploaded straight from client memory */
+	static unsigned int uploadDirect(Job& job);
+};
+
+#endif
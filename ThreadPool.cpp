@@ -0,0 +1,72 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threadCount) : stopping(false)
+{
+	if (threadCount == 0)
+	{
+		const auto hardwareThreads = std::thread::hardware_concurrency();
+
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	workers.reserve(threadCount);
+
+	for (auto i = 0u; i < threadCount; ++i)
+	{
+		workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		stopping = true;
+	}
+
+	condition.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+unsigned int ThreadPool::size() const
+{
+	return static_cast<unsigned int>(workers.size());
+}
+
+ThreadPool& ThreadPool::shared()
+{
+	static ThreadPool pool;
+
+	return pool;
+}
+
+void ThreadPool::workerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+			/* drain the queue before stopping so no future is left without a value */
+			if (tasks.empty())
+			{
+				return;
+			}
+
+			task = std::move(tasks.front());
+
+			tasks.pop();
+		}
+
+		task();
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/* fixed size pool of worker threads for CPU only work (file I/O, decoding, mesh processing), never touch GL from a task */
+class ThreadPool
+{
+public:
+	/* creates threadCount workers, 0 picks one less than the number of hardware threads (at least one) */
+	explicit ThreadPool(unsigned int threadCount = 0);
+
+	/* finishes all queued tasks, then joins the workers */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/* queues a task, the returned future holds its result (or exception) */
+	template <typename Task>
+	std::future<typename std::result_of<Task()>::type> submit(Task task);
+
+	unsigned int size() const;
+
+	/* process wide pool shared by the loaders */
+	static ThreadPool& shared();
+
+private:
+	std::vector<std::thread> workers;
+
+	std::queue<std::function<void()>> tasks;
+
+	std::mutex mutex;
+
+	std::condition_variable condition;
+
+	bool stopping;
+
+	void workerLoop();
+};
+
+template <typename Task>
+std::future<typename std::result_of<Task()>::type> ThreadPool::submit(Task task)
+{
+	using Result = typename std::result_of<Task()>::type;
+
+	/* std::function needs a copyable target, so the move-only packaged_task is shared */
+	const auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+
+	auto future = packagedTask->get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		tasks.emplace([packagedTask]() { (*packagedTask)(); });
+	}
+
+	condition.notify_one();
+
+	return future;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#include "UniformBuffer.h"
+#include "GLStateCache.h"
+
+UniformBuffer::UniformBuffer(const size_t size, const GLuint binding) : ID(0), size(size), binding(binding)
+{
+	glGenBuffers(1, &ID);
+
+	GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, ID);
+
+	glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+
+	bind();
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	GLStateCache::forgetBuffer(ID);
+
+	glDeleteBuffers(1, &ID);
+}
+
+void UniformBuffer::update(const void* data, const size_t size)
+{
+	GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, ID);
+
+	glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(this->size), nullptr, GL_DYNAMIC_DRAW);
+
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size < this->size ? size : this->size), data);
+}
+
+void UniformBuffer::bind() const
+{
+	GLStateCache::bindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+}
+
+GLuint UniformBuffer::getID() const
+{
+	return ID;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+/* fixed binding points of the shared uniform blocks declared in Shaders/include */
+enum UniformBlockBinding : GLuint
+{
+	FRAME_DATA_BINDING = 0,
+
+	LIGHT_DATA_BINDING = 1
+};
+
+/* block name -> binding point, every program gets the blocks it declares bound to these right after linking */
+struct UniformBlockDesc
+{
+	const char* name;
+
+	GLuint binding;
+};
+
+const UniformBlockDesc SHARED_UNIFORM_BLOCKS[] = {
+	{"FrameData", FRAME_DATA_BINDING},
+	{"LightData", LIGHT_DATA_BINDING},
+};
+
+/* owns a uniform buffer object attached to a fixed binding point */
+class UniformBuffer
+{
+public:
+	UniformBuffer(size_t size, GLuint binding);
+
+	~UniformBuffer();
+
+	UniformBuffer(const UniformBuffer&) = delete;
+
+	UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+	/* replaces the first size bytes, the previous storage is orphaned so the draws still reading it don't stall */
+	void update(const void* data, size_t size);
+
+	/* re-attaches the buffer, only needed if something else was bound to the binding point */
+	void bind() const;
+
+	GLuint getID() const;
+
+private:
+	GLuint ID;
+
+	size_t size;
+
+	GLuint binding;
+};
+
+#endif